@@ -0,0 +1,183 @@
+//
+//  benchmark_utils.h
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 10/11/2025.
+//
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include "../src/dictionary/dictionary.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace benchmark_utils {
+
+/// Order in which a workload touches keys
+enum class KeyOrder {
+  kRandom,  ///< Every key once, shuffled
+  kSorted,  ///< Every key once, ascending
+  kReverse, ///< Every key once, descending
+  kZipf     ///< Keys drawn with Zipf distribution, popular keys repeat
+};
+
+/**
+ * @brief Zipf-distributed ranks in [0, count), rank 0 is most popular.
+ *
+ * Uses the approximation of Gray et al. also used by YCSB: O(count) setup
+ * without tables, O(1) per sample.
+ */
+class ZipfGenerator {
+public:
+  /**
+   * @param count Number of distinct ranks
+   * @param theta Skew, 0.99 as in YCSB
+   */
+  explicit ZipfGenerator(size_t count, double theta = 0.99)
+      : count_(count), theta_(theta) {
+    for (size_t i = 1; i <= count; ++i)
+      zeta_n_ += 1.0 / std::pow(static_cast<double>(i), theta);
+    double zeta_2 = 1.0 + 1.0 / std::pow(2.0, theta);
+    alpha_ = 1.0 / (1.0 - theta);
+    eta_ = (1.0 - std::pow(2.0 / count, 1.0 - theta)) /
+           (1.0 - zeta_2 / zeta_n_);
+  }
+
+  /**
+   * @brief Draws next rank.
+   * @param generator Source of randomness
+   * @return Rank in [0, count)
+   */
+  template <typename Generator> size_t operator()(Generator &generator) {
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(generator);
+    double uz = u * zeta_n_;
+    if (uz < 1.0)
+      return 0;
+    if (uz < 1.0 + std::pow(0.5, theta_))
+      return 1;
+    size_t rank = static_cast<size_t>(count_ *
+                                      std::pow(eta_ * u - eta_ + 1, alpha_));
+    return std::min(rank, count_ - 1);
+  }
+
+private:
+  size_t count_;        ///< Number of distinct ranks
+  double theta_;        ///< Skew
+  double zeta_n_ = 0.0; ///< Generalized harmonic number of count
+  double alpha_;        ///< 1 / (1 - theta)
+  double eta_;          ///< Precomputed term of the approximation
+};
+
+/**
+ * @brief Generates count distinct keys in random order.
+ * @param count Number of keys
+ * @param seed Seed of the random generator
+ * @return Keys spread over the whole 64-bit range
+ */
+inline std::vector<uint64_t> GenerateKeys(size_t count, unsigned seed = 42) {
+  std::mt19937_64 generator(seed);
+  std::unordered_set<uint64_t> seen;
+  std::vector<uint64_t> keys;
+  keys.reserve(count);
+  while (keys.size() < count) {
+    uint64_t key = generator();
+    if (seen.insert(key).second)
+      keys.push_back(key);
+  }
+  return keys;
+}
+
+/**
+ * @brief Arranges keys into a workload of the same length.
+ * @param keys Distinct keys in random order
+ * @param order Order of the workload
+ * @param seed Seed of the random generator for Zipf workload
+ * @return Keys in workload order, with repeats for KeyOrder::kZipf
+ */
+inline std::vector<uint64_t> MakeWorkload(const std::vector<uint64_t> &keys,
+                                          KeyOrder order, unsigned seed = 7) {
+  std::vector<uint64_t> workload = keys;
+  switch (order) {
+  case KeyOrder::kRandom:
+    break;
+  case KeyOrder::kSorted:
+    std::sort(workload.begin(), workload.end());
+    break;
+  case KeyOrder::kReverse:
+    std::sort(workload.rbegin(), workload.rend());
+    break;
+  case KeyOrder::kZipf: {
+    // keys are shuffled, so popular ranks are spread over the key space
+    std::mt19937_64 generator(seed);
+    ZipfGenerator zipf(keys.size());
+    for (uint64_t &key : workload)
+      key = keys[zipf(generator)];
+    break;
+  }
+  }
+  return workload;
+}
+
+/**
+ * @brief Generates distinct random lowercase English words.
+ * @param count Number of words
+ * @param seed Seed of the random generator
+ * @return Words in random order
+ */
+inline std::vector<std::string> GenerateEnglishWords(size_t count,
+                                                     unsigned seed = 42) {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> length_distribution(3, 12);
+  std::uniform_int_distribution<int> letter_distribution('a', 'z');
+  std::unordered_set<std::string> seen;
+  std::vector<std::string> words;
+  words.reserve(count);
+  while (words.size() < count) {
+    std::string word(length_distribution(generator), 'a');
+    for (char &letter : word)
+      letter = static_cast<char>(letter_distribution(generator));
+    if (seen.insert(word).second)
+      words.push_back(std::move(word));
+  }
+  return words;
+}
+
+/**
+ * @brief Generates a random lowercase Russian word.
+ * @param generator Source of randomness
+ * @return Word of 3 to 12 Cyrillic letters in UTF-8
+ */
+inline std::string GenerateRussianWord(std::mt19937 &generator) {
+  std::uniform_int_distribution<int> length_distribution(3, 12);
+  // Lowercase а..я are U+0430..U+044F
+  std::uniform_int_distribution<int> letter_distribution(0x430, 0x44F);
+  std::string word;
+  for (int i = length_distribution(generator); i > 0; --i) {
+    int letter = letter_distribution(generator);
+    word += static_cast<char>(0xC0 | (letter >> 6));
+    word += static_cast<char>(0x80 | (letter & 0x3F));
+  }
+  return word;
+}
+
+/**
+ * @brief Builds a dictionary with every word translated to "слово".
+ * @param words English words
+ * @return Dictionary with all the words
+ */
+inline Dictionary MakeDictionary(const std::vector<std::string> &words) {
+  Dictionary dict;
+  for (const std::string &word : words)
+    dict += std::make_pair(word, std::string("слово"));
+  return dict;
+}
+
+} // namespace benchmark_utils
+
+#endif // BENCHMARK_UTILS_H
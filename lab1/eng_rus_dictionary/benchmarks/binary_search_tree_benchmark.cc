@@ -0,0 +1,247 @@
+//
+//  binary_search_tree_benchmark.cc
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 18/11/2025.
+//
+#include "../src/binary_search_tree/binary_search_tree.hpp"
+#include "benchmark_utils.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// Basic operations of BinarySearchTree with heap and pool nodes against
+// std::map and std::unordered_map. Per-key operations run over a workload
+// of n keys in random, sorted, reverse or Zipf order, with 1k to 10M keys.
+// Find, Erase and operator[] work on a container built from all n keys,
+// the Zipf workload mostly hits a small set of popular keys. A splay tree
+// with pool nodes runs Insert, Find and operator[] to compare with the AVL
+// pool tree, the Zipf workload shows what keeping hot keys near the root
+// buys against rotating on every access.
+
+namespace {
+
+using benchmark_utils::KeyOrder;
+
+using HeapTree = BinarySearchTree<uint64_t, uint64_t>;
+using PoolTree =
+    BinarySearchTree<uint64_t, uint64_t, AvlBalancing, PoolNodeAllocation>;
+using SplayTree =
+    BinarySearchTree<uint64_t, uint64_t, SplayBalancing, PoolNodeAllocation>;
+using StdMap = std::map<uint64_t, uint64_t>;
+using StdUnorderedMap = std::unordered_map<uint64_t, uint64_t>;
+
+/**
+ * @brief Operations of BinarySearchTree under common names.
+ */
+template <typename Container> struct Ops {
+  static void Insert(Container &container, uint64_t key) {
+    container.Insert(key, key);
+  }
+  static bool Find(const Container &container, uint64_t key) {
+    return container.Find(key) != nullptr;
+  }
+  static void Erase(Container &container, uint64_t key) {
+    container.Erase(key);
+  }
+  static void Clear(Container &container) { container.Clear(); }
+  template <typename Func>
+  static void Traverse(const Container &container, Func func) {
+    container.InOrderTraversal(func);
+  }
+};
+
+/**
+ * @brief Operations of standard maps, the unordered one is traversed in
+ * bucket order.
+ */
+template <typename Container> struct StdOps {
+  static void Insert(Container &container, uint64_t key) {
+    container.emplace(key, key);
+  }
+  static bool Find(const Container &container, uint64_t key) {
+    return container.find(key) != container.end();
+  }
+  static void Erase(Container &container, uint64_t key) {
+    container.erase(key);
+  }
+  static void Clear(Container &container) { container.clear(); }
+  template <typename Func>
+  static void Traverse(const Container &container, Func func) {
+    for (const auto &[key, value] : container)
+      func(key, value);
+  }
+};
+template <> struct Ops<StdMap> : StdOps<StdMap> {};
+template <> struct Ops<StdUnorderedMap> : StdOps<StdUnorderedMap> {};
+
+constexpr int64_t kSizes[] = {1'000, 10'000, 100'000, 1'000'000, 10'000'000};
+
+const char *OrderName(KeyOrder order) {
+  switch (order) {
+  case KeyOrder::kRandom:
+    return "random";
+  case KeyOrder::kSorted:
+    return "sorted";
+  case KeyOrder::kReverse:
+    return "reverse";
+  case KeyOrder::kZipf:
+    return "zipf";
+  }
+  return "";
+}
+
+/// Registers every size with every key order
+void WorkloadArgs(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"keys", "order"});
+  for (int64_t size : kSizes) {
+    for (KeyOrder order : {KeyOrder::kRandom, KeyOrder::kSorted,
+                           KeyOrder::kReverse, KeyOrder::kZipf})
+      benchmark->Args({size, static_cast<int64_t>(order)});
+  }
+}
+
+/// Registers every size
+void SizeArgs(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"keys"});
+  for (int64_t size : kSizes)
+    benchmark->Args({size});
+}
+
+/**
+ * @brief Keys and workload described by state arguments.
+ */
+struct Workload {
+  std::vector<uint64_t> keys;  ///< Distinct keys in random order
+  std::vector<uint64_t> order; ///< Keys in workload order
+
+  explicit Workload(benchmark::State &state)
+      : keys(benchmark_utils::GenerateKeys(state.range(0))),
+        order(benchmark_utils::MakeWorkload(
+            keys, static_cast<KeyOrder>(state.range(1)))) {
+    state.SetLabel(OrderName(static_cast<KeyOrder>(state.range(1))));
+  }
+};
+
+template <typename Container>
+Container MakeContainer(const std::vector<uint64_t> &keys) {
+  Container container;
+  for (uint64_t key : keys)
+    Ops<Container>::Insert(container, key);
+  return container;
+}
+
+} // namespace
+
+template <typename Container> static void BM_Insert(benchmark::State &state) {
+  Workload workload(state);
+  for (auto _ : state) {
+    Container container;
+    for (uint64_t key : workload.order)
+      Ops<Container>::Insert(container, key);
+    benchmark::DoNotOptimize(&container);
+    state.PauseTiming();
+    container = Container();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * workload.order.size());
+}
+
+template <typename Container> static void BM_Find(benchmark::State &state) {
+  Workload workload(state);
+  Container container = MakeContainer<Container>(workload.keys);
+  for (auto _ : state) {
+    for (uint64_t key : workload.order)
+      benchmark::DoNotOptimize(Ops<Container>::Find(container, key));
+  }
+  state.SetItemsProcessed(state.iterations() * workload.order.size());
+}
+
+template <typename Container> static void BM_Erase(benchmark::State &state) {
+  Workload workload(state);
+  Container container = MakeContainer<Container>(workload.keys);
+  for (auto _ : state) {
+    state.PauseTiming();
+    Container copy = container;
+    state.ResumeTiming();
+    for (uint64_t key : workload.order)
+      Ops<Container>::Erase(copy, key);
+    benchmark::DoNotOptimize(&copy);
+    state.PauseTiming();
+    copy = Container();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * workload.order.size());
+}
+
+template <typename Container>
+static void BM_Subscript(benchmark::State &state) {
+  Workload workload(state);
+  Container container = MakeContainer<Container>(workload.keys);
+  for (auto _ : state) {
+    for (uint64_t key : workload.order)
+      ++container[key];
+    benchmark::DoNotOptimize(&container);
+  }
+  state.SetItemsProcessed(state.iterations() * workload.order.size());
+}
+
+template <typename Container>
+static void BM_CopyConstruct(benchmark::State &state) {
+  Container container =
+      MakeContainer<Container>(benchmark_utils::GenerateKeys(state.range(0)));
+  for (auto _ : state) {
+    Container copy = container;
+    benchmark::DoNotOptimize(&copy);
+    state.PauseTiming();
+    copy = Container();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container> static void BM_Clear(benchmark::State &state) {
+  Container container =
+      MakeContainer<Container>(benchmark_utils::GenerateKeys(state.range(0)));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Container copy = container;
+    state.ResumeTiming();
+    Ops<Container>::Clear(copy);
+    benchmark::DoNotOptimize(&copy);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container>
+static void BM_InOrderTraversal(benchmark::State &state) {
+  Container container =
+      MakeContainer<Container>(benchmark_utils::GenerateKeys(state.range(0)));
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    Ops<Container>::Traverse(container, [&sum](uint64_t key, uint64_t value) {
+      sum += key ^ value;
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define REGISTER_CONTAINERS(benchmark_name, args)                              \
+  BENCHMARK_TEMPLATE(benchmark_name, HeapTree)->Apply(args);                   \
+  BENCHMARK_TEMPLATE(benchmark_name, PoolTree)->Apply(args);                   \
+  BENCHMARK_TEMPLATE(benchmark_name, StdMap)->Apply(args);                     \
+  BENCHMARK_TEMPLATE(benchmark_name, StdUnorderedMap)->Apply(args)
+
+REGISTER_CONTAINERS(BM_Insert, WorkloadArgs);
+REGISTER_CONTAINERS(BM_Find, WorkloadArgs);
+REGISTER_CONTAINERS(BM_Erase, WorkloadArgs);
+REGISTER_CONTAINERS(BM_Subscript, WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_Insert, SplayTree)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_Find, SplayTree)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_Subscript, SplayTree)->Apply(WorkloadArgs);
+REGISTER_CONTAINERS(BM_CopyConstruct, SizeArgs);
+REGISTER_CONTAINERS(BM_Clear, SizeArgs);
+REGISTER_CONTAINERS(BM_InOrderTraversal, SizeArgs);
@@ -0,0 +1,101 @@
+//
+//  concurrent_dictionary_benchmark.cc
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 15/11/2025.
+//
+#include "../src/concurrent_dictionary/concurrent_dictionary.h"
+#include "benchmark_utils.h"
+#include <benchmark/benchmark.h>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// Lookup throughput from 1 to 32 threads, thread 0 of the *WithWriter
+// cases also replaces a word on every 64th iteration. The baseline guards
+// Dictionary with a reader-writer lock.
+
+namespace {
+
+constexpr size_t kWords = 1 << 16;
+constexpr int kWriteEvery = 64;
+
+const std::vector<std::string> &Words() {
+  static const std::vector<std::string> words =
+      benchmark_utils::GenerateEnglishWords(kWords);
+  return words;
+}
+
+ConcurrentDictionary &SharedConcurrentDictionary() {
+  static ConcurrentDictionary *dict = [] {
+    auto *result = new ConcurrentDictionary();
+    for (const std::string &word : Words())
+      *result += std::make_pair(word, std::string("слово"));
+    return result;
+  }();
+  return *dict;
+}
+
+struct LockedDictionary {
+  Dictionary dict = benchmark_utils::MakeDictionary(Words());
+  std::shared_mutex mutex;
+};
+
+LockedDictionary &SharedLockedDictionary() {
+  static LockedDictionary *locked = new LockedDictionary();
+  return *locked;
+}
+
+} // namespace
+
+template <bool kWithWriter>
+static void BM_ConcurrentDictionaryFind(benchmark::State &state) {
+  const auto &words = Words();
+  ConcurrentDictionary &dict = SharedConcurrentDictionary();
+  size_t index = state.thread_index() * 7919 % kWords;
+  int iteration = 0;
+  for (auto _ : state) {
+    if (kWithWriter && state.thread_index() == 0 &&
+        ++iteration % kWriteEvery == 0) {
+      dict += std::make_pair(words[index], std::string("слово"));
+    } else {
+      benchmark::DoNotOptimize(dict.Find(words[index]));
+    }
+    if (++index == kWords)
+      index = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ConcurrentDictionaryFind, false)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentDictionaryFind, true)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+template <bool kWithWriter>
+static void BM_LockedDictionaryFind(benchmark::State &state) {
+  const auto &words = Words();
+  LockedDictionary &locked = SharedLockedDictionary();
+  size_t index = state.thread_index() * 7919 % kWords;
+  int iteration = 0;
+  for (auto _ : state) {
+    if (kWithWriter && state.thread_index() == 0 &&
+        ++iteration % kWriteEvery == 0) {
+      std::unique_lock<std::shared_mutex> lock(locked.mutex);
+      locked.dict += std::make_pair(words[index], std::string("слово"));
+    } else {
+      std::shared_lock<std::shared_mutex> lock(locked.mutex);
+      benchmark::DoNotOptimize(locked.dict.Find(words[index]));
+    }
+    if (++index == kWords)
+      index = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_LockedDictionaryFind, false)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_LockedDictionaryFind, true)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
@@ -0,0 +1,388 @@
+//
+//  dictionary_benchmark.cc
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 18/11/2025.
+//
+#include "benchmark_utils.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Dictionary operations on words: loading a generated file of several
+// megabytes in random and in alphabetical order and by several threads,
+// adding words one by one and operator[] lookups of existing words through
+// the const and the mutable overloads. Short-lived glossaries are built,
+// queried and destroyed with the default memory resource and inside a
+// monotonic buffer. Exact lookups through the tree and through the hash
+// index are compared, the index reports the memory it adds per word next to
+// the memory of the tree. LookupBatch translates the same words in batches
+// of a text line or page. A binary file written by ConvertToBinary is
+// opened and queried without building a tree. Complete returns the ten
+// heaviest completions of short prefixes, against scanning the prefix
+// range for them
+
+namespace {
+
+/**
+ * @brief Dictionary file in the temporary directory, removed on
+ * destruction.
+ */
+class DictionaryFile {
+public:
+  /**
+   * @brief Writes count random word pairs, one "english:russian" per line.
+   * @param count Number of lines
+   * @param sorted Whether lines are in alphabetical order, as written by
+   * operator<<
+   */
+  explicit DictionaryFile(size_t count, bool sorted = false)
+      : path_((std::filesystem::temp_directory_path() /
+               ("dictionary_benchmark_" + std::to_string(count) + ".txt"))
+                  .string()) {
+    std::mt19937 generator(42);
+    std::ofstream file(path_);
+    auto words = benchmark_utils::GenerateEnglishWords(count);
+    if (sorted)
+      std::sort(words.begin(), words.end());
+    for (const std::string &word : words) {
+      file << word << ':' << benchmark_utils::GenerateRussianWord(generator)
+           << '\n';
+    }
+    size_ = static_cast<size_t>(file.tellp());
+  }
+  ~DictionaryFile() { std::remove(path_.c_str()); }
+
+  DictionaryFile(const DictionaryFile &) = delete;
+  DictionaryFile &operator=(const DictionaryFile &) = delete;
+
+  const std::string &GetPath() const { return path_; }
+  size_t GetSize() const { return size_; }
+
+private:
+  std::string path_; ///< Path of the file
+  size_t size_ = 0;  ///< Size of the file in bytes
+};
+
+/**
+ * @brief Builds a dictionary of words for completion.
+ * @param words English words
+ * @param weighted Whether words get random weights
+ */
+Dictionary MakeWeightedDictionary(const std::vector<std::string> &words,
+                                  bool weighted) {
+  Dictionary dict = benchmark_utils::MakeDictionary(words);
+  if (weighted) {
+    std::mt19937 generator(5);
+    for (const std::string &word : words)
+      dict.SetWeight(word, generator() % 100000);
+  }
+  return dict;
+}
+
+} // namespace
+
+static void BM_DictionaryLoadFromFile(benchmark::State &state) {
+  DictionaryFile file(state.range(0), state.range(1) != 0);
+  for (auto _ : state) {
+    Dictionary dict;
+    benchmark::DoNotOptimize(dict.LoadFromFile(file.GetPath()));
+    state.PauseTiming();
+    dict = Dictionary();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * file.GetSize());
+}
+// 2^16 lines are about 1.5 MB, 2^22 lines about 100 MB. Lines of a sorted
+// file need no sorting before the tree is built
+BENCHMARK(BM_DictionaryLoadFromFile)
+    ->ArgNames({"lines", "sorted"})
+    ->ArgsProduct({benchmark::CreateRange(1 << 16, 1 << 22, 4), {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_DictionaryLoadFromFileParallel(benchmark::State &state) {
+  DictionaryFile file(state.range(0));
+  for (auto _ : state) {
+    Dictionary dict;
+    benchmark::DoNotOptimize(
+        dict.LoadFromFile(file.GetPath(), state.range(1)));
+    state.PauseTiming();
+    dict = Dictionary();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * file.GetSize());
+}
+BENCHMARK(BM_DictionaryLoadFromFileParallel)
+    ->ArgNames({"lines", "threads"})
+    ->ArgsProduct({{1 << 20, 1 << 22}, {1, 2, 4, 8, 16}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_DictionaryOpenBinary(benchmark::State &state) {
+  DictionaryFile file(state.range(0));
+  std::string path = file.GetPath() + ".sst";
+  Dictionary::ConvertToBinary(file.GetPath(), path);
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  // Opening and the first lookup, against BM_DictionaryLoadFromFile
+  for (auto _ : state) {
+    BinaryDictionary dict = Dictionary::OpenBinary(path);
+    benchmark::DoNotOptimize(dict.Find(words[0]));
+  }
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_DictionaryOpenBinary)
+    ->Arg(1 << 20)
+    ->Arg(1 << 22)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_BinaryDictionaryFind(benchmark::State &state) {
+  DictionaryFile file(state.range(0));
+  std::string path = file.GetPath() + ".sst";
+  Dictionary::ConvertToBinary(file.GetPath(), path);
+  BinaryDictionary dict = Dictionary::OpenBinary(path);
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  size_t index = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dict.Find(words[index]));
+    if (++index == words.size())
+      index = 0;
+  }
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_BinaryDictionaryFind)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void BM_DictionaryAddWords(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  for (auto _ : state) {
+    Dictionary dict;
+    for (const std::string &word : words)
+      dict += {word, "слово"};
+    benchmark::DoNotOptimize(dict.GetSize());
+    state.PauseTiming();
+    dict = Dictionary();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DictionaryAddWords)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void BM_DictionarySubscript(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  Dictionary dict = benchmark_utils::MakeDictionary(words);
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  size_t index = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dict[words[index]]);
+    if (++index == words.size())
+      index = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DictionarySubscript)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void BM_DictionaryConstSubscript(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  Dictionary dict = benchmark_utils::MakeDictionary(words);
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  size_t index = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::as_const(dict)[words[index]]);
+    if (++index == words.size())
+      index = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DictionaryConstSubscript)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 22);
+
+namespace {
+
+/**
+ * @brief Memory resource counting bytes currently allocated through it.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+  size_t GetAllocated() const { return allocated_; }
+
+private:
+  size_t allocated_ = 0; ///< Bytes allocated and not yet deallocated
+
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    allocated_ += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *pointer, size_t bytes, size_t alignment) override {
+    allocated_ -= bytes;
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+} // namespace
+
+static void BM_DictionaryFind(benchmark::State &state) {
+  bool hash_index = state.range(1) != 0;
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  CountingResource resource;
+  Dictionary dict(&resource);
+  for (const std::string &word : words)
+    dict += std::make_pair(word, std::string("слово"));
+  size_t tree_bytes = resource.GetAllocated();
+  dict.SetHashIndex(hash_index);
+  size_t index_bytes = resource.GetAllocated() - tree_bytes;
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  size_t index = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dict.Find(words[index]));
+    if (++index == words.size())
+      index = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(hash_index ? "hash index" : "tree");
+  state.counters["tree_bytes_per_word"] =
+      static_cast<double>(tree_bytes) / words.size();
+  state.counters["index_bytes_per_word"] =
+      static_cast<double>(index_bytes) / words.size();
+}
+BENCHMARK(BM_DictionaryFind)
+    ->ArgNames({"words", "hash_index"})
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 22, 8), {0, 1}});
+
+namespace {
+
+/**
+ * @brief Builds a glossary, looks every word up and destroys it.
+ * @param pairs Words and translations of the glossary
+ * @param resource Memory resource of the glossary
+ */
+void UseGlossary(
+    const std::vector<std::pair<std::string, std::string>> &pairs,
+    std::pmr::memory_resource *resource) {
+  Dictionary glossary(resource);
+  for (const auto &word_pair : pairs)
+    glossary += word_pair;
+  for (const auto &word_pair : pairs)
+    benchmark::DoNotOptimize(glossary.Find(word_pair.first));
+}
+
+std::vector<std::pair<std::string, std::string>>
+MakeGlossaryPairs(size_t count) {
+  std::mt19937 generator(42);
+  std::vector<std::pair<std::string, std::string>> pairs;
+  for (std::string &word : benchmark_utils::GenerateEnglishWords(count))
+    pairs.emplace_back(std::move(word),
+                       benchmark_utils::GenerateRussianWord(generator));
+  return pairs;
+}
+
+} // namespace
+
+static void BM_GlossaryDefaultResource(benchmark::State &state) {
+  auto pairs = MakeGlossaryPairs(state.range(0));
+  for (auto _ : state)
+    UseGlossary(pairs, std::pmr::get_default_resource());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GlossaryDefaultResource)->RangeMultiplier(8)->Range(16, 4096);
+
+static void BM_GlossaryMonotonicBuffer(benchmark::State &state) {
+  auto pairs = MakeGlossaryPairs(state.range(0));
+  std::vector<std::byte> buffer(state.range(0) * 256);
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    UseGlossary(pairs, &arena);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GlossaryMonotonicBuffer)->RangeMultiplier(8)->Range(16, 4096);
+
+static void BM_DictionaryLookupBatch(benchmark::State &state) {
+  bool hash_index = state.range(2) != 0;
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  Dictionary dict = benchmark_utils::MakeDictionary(words);
+  dict.SetHashIndex(hash_index);
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  std::vector<std::string_view> views(words.begin(), words.end());
+  size_t batch = state.range(1);
+  size_t index = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dict.LookupBatch(views.data() + index, batch));
+    index += batch;
+    if (index + batch > views.size())
+      index = 0;
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+  state.SetLabel(hash_index ? "hash index" : "tree");
+}
+BENCHMARK(BM_DictionaryLookupBatch)
+    ->ArgNames({"words", "batch", "hash_index"})
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 22, 8), {16, 1024},
+                   {0, 1}});
+
+static void BM_DictionaryComplete(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  Dictionary dict = MakeWeightedDictionary(words, state.range(2) != 0);
+  dict.Complete("", 1); // builds the index of weights
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  size_t prefix_length = state.range(1);
+  size_t index = 0;
+  for (auto _ : state) {
+    std::string_view word = words[index];
+    benchmark::DoNotOptimize(
+        dict.Complete(word.substr(0, prefix_length), 10));
+    if (++index == words.size())
+      index = 0;
+  }
+  state.SetLabel(state.range(2) ? "weighted" : "alphabetical");
+}
+BENCHMARK(BM_DictionaryComplete)
+    ->ArgNames({"words", "prefix", "weighted"})
+    ->ArgsProduct({{1 << 20}, {1, 2, 3}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_DictionaryCompleteByScan(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  Dictionary dict = MakeWeightedDictionary(words, true);
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  size_t prefix_length = state.range(1);
+  size_t index = 0;
+  // Ten heaviest words of the prefix range kept in a heap, lightest on top
+  using Candidate = std::pair<uint64_t, const Dictionary::WordPair *>;
+  auto heavier = [](const Candidate &first, const Candidate &second) {
+    return first.first > second.first;
+  };
+  for (auto _ : state) {
+    auto range = dict.FindPrefix(words[index].substr(0, prefix_length));
+    std::vector<Candidate> heaviest;
+    for (auto it = range.first; it != range.second; ++it) {
+      heaviest.emplace_back(dict.GetWeight(it->first), &*it);
+      std::push_heap(heaviest.begin(), heaviest.end(), heavier);
+      if (heaviest.size() > 10) {
+        std::pop_heap(heaviest.begin(), heaviest.end(), heavier);
+        heaviest.pop_back();
+      }
+    }
+    benchmark::DoNotOptimize(heaviest.data());
+    if (++index == words.size())
+      index = 0;
+  }
+}
+BENCHMARK(BM_DictionaryCompleteByScan)
+    ->ArgNames({"words", "prefix"})
+    ->ArgsProduct({{1 << 20}, {1, 2, 3}})
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,57 @@
+//
+//  frozen_dictionary_benchmark.cc
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 10/11/2025.
+//
+#include "../src/frozen_dictionary/frozen_dictionary.h"
+#include "benchmark_utils.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Lookups of existing words in random order, so that large dictionaries
+// don't fit in cache and every level of the search may miss
+
+static void BM_DictionaryFind(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  Dictionary dict = benchmark_utils::MakeDictionary(words);
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  size_t index = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dict.Find(words[index]));
+    if (++index == words.size())
+      index = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DictionaryFind)->RangeMultiplier(8)->Range(1 << 10, 1 << 21);
+
+static void BM_FrozenDictionaryFind(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  FrozenDictionary frozen(benchmark_utils::MakeDictionary(words));
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  size_t index = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(frozen.Find(words[index]));
+    if (++index == words.size())
+      index = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FrozenDictionaryFind)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 21);
+
+static void BM_FrozenDictionaryBuild(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  Dictionary dict = benchmark_utils::MakeDictionary(words);
+  for (auto _ : state) {
+    FrozenDictionary frozen(dict);
+    benchmark::DoNotOptimize(frozen.GetSize());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrozenDictionaryBuild)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 19);
@@ -0,0 +1,9 @@
+//
+//  main_benchmark.cc
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 10/11/2025.
+//
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+//
+//  mapped_tree_benchmark.cc
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 20/11/2025.
+//
+#include "../src/mapped_dictionary/mapped_dictionary.h"
+#include "../src/mapped_tree/mapped_tree.h"
+#include "benchmark_utils.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+// MappedTree against the in-memory dictionary: opening a file written
+// earlier (compare with BM_DictionaryLoadFromFile, which parses text and
+// builds the tree), random lookups and inserting words into the mapping
+
+namespace {
+
+/**
+ * @brief Tree file of count random word pairs in the temporary directory,
+ * removed on destruction.
+ */
+class TreeFile {
+public:
+  explicit TreeFile(size_t count)
+      : path_((std::filesystem::temp_directory_path() /
+               ("mapped_tree_benchmark_" + std::to_string(count) + ".tree"))
+                  .string()),
+        words_(benchmark_utils::GenerateEnglishWords(count)) {
+    std::remove(path_.c_str());
+    std::mt19937 generator(42);
+    MappedTree tree(path_);
+    for (const std::string &word : words_)
+      tree.Insert(word, benchmark_utils::GenerateRussianWord(generator));
+    tree.Sync();
+  }
+  ~TreeFile() { std::remove(path_.c_str()); }
+
+  TreeFile(const TreeFile &) = delete;
+  TreeFile &operator=(const TreeFile &) = delete;
+
+  const std::string &GetPath() const { return path_; }
+  const std::vector<std::string> &GetWords() const { return words_; }
+
+private:
+  std::string path_;               ///< Path of the file
+  std::vector<std::string> words_; ///< Words stored in the file
+};
+
+} // namespace
+
+static void BM_MappedDictionaryOpen(benchmark::State &state) {
+  TreeFile file(state.range(0));
+  for (auto _ : state) {
+    MappedDictionary dict(file.GetPath());
+    benchmark::DoNotOptimize(dict.Find(file.GetWords().front()));
+  }
+}
+BENCHMARK(BM_MappedDictionaryOpen)
+    ->RangeMultiplier(4)
+    ->Range(1 << 16, 1 << 22)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_MappedTreeFind(benchmark::State &state) {
+  TreeFile file(state.range(0));
+  MappedTree tree(file.GetPath());
+  std::vector<std::string> words = file.GetWords();
+  std::shuffle(words.begin(), words.end(), std::mt19937(7));
+  size_t index = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tree.Find(words[index]));
+    if (++index == words.size())
+      index = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MappedTreeFind)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void BM_MappedTreeInsert(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  std::string path = (std::filesystem::temp_directory_path() /
+                      "mapped_tree_benchmark_insert.tree")
+                         .string();
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::remove(path.c_str());
+    state.ResumeTiming();
+    MappedTree tree(path);
+    for (const std::string &word : words)
+      tree.Insert(word, "слово");
+    benchmark::DoNotOptimize(tree.GetSize());
+  }
+  std::remove(path.c_str());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MappedTreeInsert)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
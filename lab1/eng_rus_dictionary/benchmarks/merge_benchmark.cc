@@ -0,0 +1,69 @@
+//
+//  merge_benchmark.cc
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 16/11/2025.
+//
+#include "benchmark_utils.h"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+// Merging a glossary of m words (half of them new) into a dictionary of
+// 2^18 words: join-based Merge against adding the words one by one
+
+namespace {
+
+constexpr size_t kDictionarySize = 1 << 18;
+
+struct MergeInput {
+  Dictionary dict;
+  Dictionary glossary;
+};
+
+MergeInput MakeMergeInput(size_t glossary_size) {
+  auto words =
+      benchmark_utils::GenerateEnglishWords(kDictionarySize + glossary_size);
+  std::vector<std::string> dict_words(words.begin(),
+                                      words.begin() + kDictionarySize);
+  std::vector<std::string> glossary_words(
+      words.begin() + kDictionarySize - glossary_size / 2,
+      words.begin() + kDictionarySize + glossary_size / 2);
+  return {benchmark_utils::MakeDictionary(dict_words),
+          benchmark_utils::MakeDictionary(glossary_words)};
+}
+
+} // namespace
+
+static void BM_DictionaryMerge(benchmark::State &state) {
+  MergeInput input = MakeMergeInput(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Dictionary dict = input.dict;
+    state.ResumeTiming();
+    dict.Merge(input.glossary);
+    benchmark::DoNotOptimize(dict.GetSize());
+    state.PauseTiming();
+    dict = Dictionary();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DictionaryMerge)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
+
+static void BM_DictionaryInsertEach(benchmark::State &state) {
+  MergeInput input = MakeMergeInput(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Dictionary dict = input.dict;
+    state.ResumeTiming();
+    for (const auto &word_pair : input.glossary)
+      dict += word_pair;
+    benchmark::DoNotOptimize(dict.GetSize());
+    state.PauseTiming();
+    dict = Dictionary();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DictionaryInsertEach)->RangeMultiplier(16)->Range(1 << 6, 1 << 18);
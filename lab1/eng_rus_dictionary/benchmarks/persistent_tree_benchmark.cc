@@ -0,0 +1,41 @@
+//
+//  persistent_tree_benchmark.cc
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 14/11/2025.
+//
+#include "../src/persistent_tree/persistent_tree.hpp"
+#include "benchmark_utils.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+// Cost of giving readers a stable view and then changing one word:
+// a deep copy of Dictionary against a snapshot of PersistentTree
+
+static void BM_DictionaryCopyAndInsert(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  Dictionary dict = benchmark_utils::MakeDictionary(words);
+  for (auto _ : state) {
+    Dictionary snapshot = dict;
+    dict += std::make_pair(words[0], std::string("новое"));
+    benchmark::DoNotOptimize(snapshot.GetSize());
+  }
+}
+BENCHMARK(BM_DictionaryCopyAndInsert)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 19);
+
+static void BM_PersistentTreeSnapshotAndInsert(benchmark::State &state) {
+  auto words = benchmark_utils::GenerateEnglishWords(state.range(0));
+  PersistentTree<std::string, std::string> tree;
+  for (const std::string &word : words)
+    tree.Insert(word, "слово");
+  for (auto _ : state) {
+    PersistentTree<std::string, std::string> snapshot = tree;
+    tree.Insert(words[0], "новое");
+    benchmark::DoNotOptimize(snapshot.GetSize());
+  }
+}
+BENCHMARK(BM_PersistentTreeSnapshotAndInsert)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 19);
@@ -0,0 +1,72 @@
+//
+//  tree_copy_destroy_benchmark.cc
+//  benchmarks
+//
+//  Created by Dmitry Burbas on 17/11/2025.
+//
+#include "../src/binary_search_tree/binary_search_tree.hpp"
+#include <benchmark/benchmark.h>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Copy and destruction of 10M-node trees, std::map as the baseline
+
+namespace {
+
+constexpr int kNodes = 10'000'000;
+
+template <typename Tree> Tree MakeTree() {
+  std::vector<std::pair<int, int>> items;
+  items.reserve(kNodes);
+  for (int i = 0; i < kNodes; ++i)
+    items.emplace_back(i, i);
+  Tree tree;
+  tree.AssignSorted(items.begin(), items.end());
+  return tree;
+}
+
+template <> std::map<int, int> MakeTree<std::map<int, int>>() {
+  std::map<int, int> tree;
+  for (int i = 0; i < kNodes; ++i)
+    tree.emplace_hint(tree.end(), i, i);
+  return tree;
+}
+
+using HeapTree = BinarySearchTree<int, int>;
+using PoolTree =
+    BinarySearchTree<int, int, AvlBalancing, PoolNodeAllocation>;
+
+} // namespace
+
+template <typename Tree> static void BM_Copy(benchmark::State &state) {
+  Tree tree = MakeTree<Tree>();
+  for (auto _ : state) {
+    Tree copy = tree;
+    benchmark::DoNotOptimize(&copy);
+    state.PauseTiming();
+    copy = Tree();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * kNodes);
+}
+BENCHMARK_TEMPLATE(BM_Copy, HeapTree)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Copy, PoolTree)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Copy, std::map<int, int>)
+    ->Unit(benchmark::kMillisecond);
+
+template <typename Tree> static void BM_Destroy(benchmark::State &state) {
+  Tree tree = MakeTree<Tree>();
+  for (auto _ : state) {
+    state.PauseTiming();
+    Tree copy = tree;
+    state.ResumeTiming();
+    copy = Tree();
+    benchmark::DoNotOptimize(&copy);
+  }
+  state.SetItemsProcessed(state.iterations() * kNodes);
+}
+BENCHMARK_TEMPLATE(BM_Destroy, HeapTree)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Destroy, PoolTree)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Destroy, std::map<int, int>)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,294 @@
+/**
+ * @file binary_dictionary.cc
+ * @brief Implementation of BinaryDictionary class methods
+ * @author Dmitry Burbas
+ * @date 23/11/2025
+ */
+
+#include "../dictionary_utils/dictionary_utils.h"
+#include "binary_dictionary.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = {'E', 'R', 'D', 'S', 'S', 'T', '\0', '\0'};
+constexpr uint32_t kVersion = 1;
+
+/// Offset basis and prime of the 64-bit FNV-1a hash
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+/**
+ * @brief Continues the FNV-1a checksum over a range of bytes.
+ * @param data Start of the range
+ * @param size Size of the range
+ * @param checksum Checksum of the preceding bytes
+ * @return Checksum including the range
+ */
+uint64_t UpdateChecksum(const char *data, size_t size, uint64_t checksum) {
+  for (size_t index = 0; index < size; ++index) {
+    checksum ^= static_cast<unsigned char>(data[index]);
+    checksum *= kFnvPrime;
+  }
+  return checksum;
+}
+
+/**
+ * @brief Appends an integer in LEB128 encoding, 7 bits per byte.
+ */
+void PutVarint(std::string &block, uint64_t value) {
+  while (value >= 0x80) {
+    block.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  block.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Reads an integer in LEB128 encoding.
+ * @param position Start of the integer, moved past it
+ * @param end End of the block
+ * @throw std::runtime\_error if the integer leaves the block
+ */
+uint64_t GetVarint(const char *&position, const char *end) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (position == end)
+      throw std::runtime_error("Corrupted dictionary file");
+    unsigned char byte = static_cast<unsigned char>(*position++);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80)
+      return value;
+  }
+  throw std::runtime_error("Corrupted dictionary file");
+}
+
+} // namespace
+
+/**
+ * @brief First bytes of the file, offsets count from its start.
+ */
+struct BinaryDictionary::Header {
+  char magic[8];             ///< kMagic
+  uint32_t version;          ///< kVersion
+  uint32_t restart_interval; ///< kRestartInterval of the writer
+  uint64_t size;             ///< Number of word pairs
+  uint64_t keys_offset;      ///< Start of the key block
+  uint64_t keys_size;        ///< Size of the key block
+  uint64_t values_offset;    ///< Start of the value block
+  uint64_t values_size;      ///< Size of the value block
+  uint64_t index_offset;     ///< Start of the sparse index
+  uint64_t restart_count;    ///< Number of entries in the index
+  uint64_t checksum;         ///< FNV-1a of all bytes after the header
+};
+
+BinaryDictionary::BinaryDictionary(const std::string &path) : file_(path) {
+  std::string_view contents = file_.GetContents();
+  uint64_t file_size = contents.size();
+  if (file_size < sizeof(Header))
+    throw std::runtime_error("Not a dictionary file: " + path);
+  Header header;
+  std::memcpy(&header, contents.data(), sizeof(Header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+    throw std::runtime_error("Not a dictionary file: " + path);
+  if (header.version != kVersion ||
+      header.restart_interval != kRestartInterval) {
+    throw std::runtime_error("Unsupported dictionary file version: " + path);
+  }
+  bool fits = header.keys_offset <= file_size &&
+              header.keys_size <= file_size - header.keys_offset &&
+              header.values_offset <= file_size &&
+              header.values_size <= file_size - header.values_offset &&
+              header.index_offset <= file_size &&
+              header.index_offset % alignof(Restart) == 0 &&
+              header.restart_count <=
+                  (file_size - header.index_offset) / sizeof(Restart) &&
+              header.restart_count ==
+                  (header.size + kRestartInterval - 1) / kRestartInterval;
+  if (!fits)
+    throw std::runtime_error("Corrupted dictionary file: " + path);
+  size_ = header.size;
+  keys_ = contents.data() + header.keys_offset;
+  keys_end_ = keys_ + header.keys_size;
+  values_ = contents.data() + header.values_offset;
+  values_size_ = header.values_size;
+  restarts_ =
+      reinterpret_cast<const Restart *>(contents.data() + header.index_offset);
+  restart_count_ = header.restart_count;
+}
+
+std::optional<std::string_view>
+BinaryDictionary::Find(std::string_view english_word) const {
+  // The last group whose first key is not greater than the word
+  size_t low = 0;
+  size_t high = restart_count_;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (RestartKey(middle) <= english_word)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  if (low == 0)
+    return std::nullopt;
+  // RestartKey has checked the offset of this group
+  size_t restart = low - 1;
+  size_t count =
+      std::min(kRestartInterval, size_ - restart * kRestartInterval);
+  std::string key;
+  const char *position = keys_ + restarts_[restart].key_offset;
+  uint64_t value_offset = restarts_[restart].value_offset;
+  for (size_t index = 0; index < count; ++index) {
+    uint64_t value_size = 0;
+    position = DecodeEntry(position, key, value_size);
+    if (key == english_word)
+      return ValueAt(value_offset, value_size);
+    if (english_word < key)
+      break;
+    value_offset += value_size;
+  }
+  return std::nullopt;
+}
+
+std::string_view
+BinaryDictionary::operator[](std::string_view english_word) const {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: word must be english");
+  }
+  std::optional<std::string_view> translation = Find(english_word);
+  if (!translation) {
+    throw std::out_of_range("Word not found: " + std::string(english_word));
+  }
+  return *translation;
+}
+
+bool BinaryDictionary::VerifyChecksum() const {
+  std::string_view contents = file_.GetContents();
+  Header header;
+  std::memcpy(&header, contents.data(), sizeof(Header));
+  return UpdateChecksum(contents.data() + sizeof(Header),
+                        contents.size() - sizeof(Header),
+                        kFnvOffsetBasis) == header.checksum;
+}
+
+std::ostream &operator<<(std::ostream &out_stream,
+                         const BinaryDictionary &dict) {
+  dict.InOrderTraversal([&out_stream](std::string_view english_word,
+                                      std::string_view russian_word) {
+    out_stream << english_word << ":" << russian_word << "\n";
+  });
+  return out_stream;
+}
+
+const char *BinaryDictionary::DecodeEntry(const char *position,
+                                          std::string &key,
+                                          uint64_t &value_size) const {
+  if (position >= keys_end_)
+    throw std::runtime_error("Corrupted dictionary file");
+  uint64_t shared = GetVarint(position, keys_end_);
+  uint64_t unshared = GetVarint(position, keys_end_);
+  value_size = GetVarint(position, keys_end_);
+  if (shared > key.size() ||
+      unshared > static_cast<uint64_t>(keys_end_ - position)) {
+    throw std::runtime_error("Corrupted dictionary file");
+  }
+  key.resize(shared);
+  key.append(position, unshared);
+  return position + unshared;
+}
+
+std::string_view BinaryDictionary::ValueAt(uint64_t offset,
+                                           uint64_t size) const {
+  if (offset > values_size_ || size > values_size_ - offset)
+    throw std::runtime_error("Corrupted dictionary file");
+  return std::string_view(values_ + offset, size);
+}
+
+std::string_view BinaryDictionary::RestartKey(size_t restart) const {
+  if (restarts_[restart].key_offset >=
+      static_cast<uint64_t>(keys_end_ - keys_)) {
+    throw std::runtime_error("Corrupted dictionary file");
+  }
+  const char *position = keys_ + restarts_[restart].key_offset;
+  // The first key of a group shares nothing with the previous one
+  uint64_t shared = GetVarint(position, keys_end_);
+  uint64_t unshared = GetVarint(position, keys_end_);
+  GetVarint(position, keys_end_);
+  if (shared != 0 || unshared > static_cast<uint64_t>(keys_end_ - position))
+    throw std::runtime_error("Corrupted dictionary file");
+  return std::string_view(position, unshared);
+}
+
+void BinaryDictionary::Writer::Add(std::string_view english_word,
+                                   std::string_view russian_word) {
+  if (size_ > 0 && !(std::string_view(last_key_) < english_word)) {
+    throw std::invalid_argument(
+        "Words must be added in increasing order: " +
+        std::string(english_word));
+  }
+  size_t shared = 0;
+  if (size_ % kRestartInterval == 0) {
+    restarts_.push_back(Restart{keys_.size(), values_.size()});
+  } else {
+    size_t limit = std::min(last_key_.size(), english_word.size());
+    while (shared < limit && last_key_[shared] == english_word[shared])
+      ++shared;
+  }
+  PutVarint(keys_, shared);
+  PutVarint(keys_, english_word.size() - shared);
+  PutVarint(keys_, russian_word.size());
+  keys_.append(english_word.substr(shared));
+  values_.append(russian_word);
+  last_key_.assign(english_word);
+  ++size_;
+}
+
+bool BinaryDictionary::Writer::Finish() {
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.restart_interval = kRestartInterval;
+  header.size = size_;
+  header.keys_offset = sizeof(Header);
+  header.keys_size = keys_.size();
+  header.values_offset = header.keys_offset + header.keys_size;
+  header.values_size = values_.size();
+  uint64_t values_end = header.values_offset + header.values_size;
+  std::string padding((alignof(Restart) - values_end % alignof(Restart)) %
+                          alignof(Restart),
+                      '\0');
+  header.index_offset = values_end + padding.size();
+  header.restart_count = restarts_.size();
+  const char *index = reinterpret_cast<const char *>(restarts_.data());
+  size_t index_size = restarts_.size() * sizeof(Restart);
+  uint64_t checksum = kFnvOffsetBasis;
+  checksum = UpdateChecksum(keys_.data(), keys_.size(), checksum);
+  checksum = UpdateChecksum(values_.data(), values_.size(), checksum);
+  checksum = UpdateChecksum(padding.data(), padding.size(), checksum);
+  header.checksum = UpdateChecksum(index, index_size, checksum);
+
+  std::string temporary_path = path_ + ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    file.write(keys_.data(), keys_.size());
+    file.write(values_.data(), values_.size());
+    file.write(padding.data(), padding.size());
+    file.write(index, index_size);
+    file.close();
+    if (!file) {
+      std::remove(temporary_path.c_str());
+      return false;
+    }
+  }
+  if (std::rename(temporary_path.c_str(), path_.c_str()) != 0) {
+    std::remove(temporary_path.c_str());
+    return false;
+  }
+  return true;
+}
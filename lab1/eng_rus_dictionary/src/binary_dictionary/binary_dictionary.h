@@ -0,0 +1,229 @@
+/**
+ * @file binary_dictionary.h
+ * @brief Read-only English-Russian dictionary in a sorted binary file
+ * @author Dmitry Burbas
+ * @date 23/11/2025
+ */
+#ifndef BINARY_DICTIONARY_H
+#define BINARY_DICTIONARY_H
+
+#include "../mapped_file/mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Dictionary opened from a sorted string table file.
+ *
+ * The file holds word pairs sorted by English word in three blocks: keys,
+ * values and a sparse index. Keys are front-coded: each one stores only
+ * the bytes that differ from the previous key, except every
+ * kRestartInterval-th key, which is stored whole and listed in the index.
+ * A lookup binary searches the index and decodes at most kRestartInterval
+ * keys, so nothing is built in memory and opening the file is mapping it
+ * and checking its header. The checksum of the blocks is checked only on
+ * demand by VerifyChecksum, since it reads the whole file.
+ *
+ * Files are written by Writer, Dictionary::SaveBinary and
+ * Dictionary::ConvertToBinary. The layout is native (byte order of the
+ * machine that wrote the file). Only POSIX systems are supported.
+ *
+ * @code
+ * Dictionary dict;
+ * dict += "hello:привет";
+ * dict.SaveBinary("words.sst");
+ * BinaryDictionary binary("words.sst"); // instant, no parsing
+ * std::cout << binary["hello"]; // Outputs: привет
+ * @endcode
+ */
+class BinaryDictionary {
+public:
+  class Writer;
+
+  /// Keys between two entries of the sparse index
+  static constexpr size_t kRestartInterval = 16;
+
+  /**
+   * @brief Opens a dictionary file.
+   * @param path Path of the file
+   * @throw std::system\_error if the file can't be opened or mapped
+   * @throw std::runtime\_error if the file is not a dictionary file of
+   * this version
+   */
+  explicit BinaryDictionary(const std::string &path);
+
+  /**
+   * @brief Looks up translation of a word without throwing.
+   *
+   * The returned view points into the file and stays valid while the
+   * dictionary lives.
+   *
+   * @param english_word Word to look up
+   * @return View of Russian translation, std::nullopt if word is absent
+   * @throw std::runtime\_error if the file is found corrupted
+   */
+  std::optional<std::string_view> Find(std::string_view english_word) const;
+
+  /**
+   * @brief Checks if the dictionary contains a word.
+   * @param english_word Word to look up
+   * @return true if word is present
+   */
+  bool Contains(std::string_view english_word) const {
+    return Find(english_word).has_value();
+  }
+
+  /**
+   * @brief Accesses translation of an English word.
+   * @param english_word English word to look up
+   * @return View of Russian translation in the file
+   * @throw std::invalid\_argument if word is not valid English
+   * @throw std::out\_of\_range if word not found
+   */
+  std::string_view operator[](std::string_view english_word) const;
+
+  /**
+   * @brief Returns the number of word pairs in the dictionary.
+   */
+  size_t GetSize() const { return size_; }
+
+  /**
+   * @brief Checks if dictionary is empty.
+   */
+  bool IsEmpty() const { return size_ == 0; }
+
+  /**
+   * @brief Reads the whole file and compares its checksum with the stored
+   * one.
+   * @return true if the blocks are intact
+   */
+  bool VerifyChecksum() const;
+
+  /**
+   * @brief In-order traversal of all pairs.
+   * @tparam Func Callable as func(std::string\_view english\_word,
+   * std::string\_view russian\_word)
+   * @param func Function called for each pair in alphabetical order, the
+   * English word view is valid only during the call
+   * @throw std::runtime\_error if the file is found corrupted
+   */
+  template <typename Func> void InOrderTraversal(Func func) const {
+    std::string key;
+    const char *position = keys_;
+    uint64_t value_offset = 0;
+    for (size_t index = 0; index < size_; ++index) {
+      uint64_t value_size = 0;
+      position = DecodeEntry(position, key, value_size);
+      func(std::string_view(key), ValueAt(value_offset, value_size));
+      value_offset += value_size;
+    }
+  }
+
+  /**
+   * @brief Output stream operator. Prints all word pairs in format
+   * "english:russian" in alphabetical order.
+   * @param out_stream Output stream
+   * @param dict Dictionary to output
+   * @return Reference to output stream
+   */
+  friend std::ostream &operator<<(std::ostream &out_stream,
+                                  const BinaryDictionary &dict);
+
+private:
+  struct Header;
+
+  /**
+   * @brief Entry of the sparse index, offsets of a whole key and its value.
+   */
+  struct Restart {
+    uint64_t key_offset;   ///< Offset of the key entry in the key block
+    uint64_t value_offset; ///< Offset of the value in the value block
+  };
+
+  MappedFile file_;                   ///< Mapping of the whole file
+  size_t size_ = 0;                   ///< Number of word pairs
+  const char *keys_ = nullptr;        ///< Start of the key block
+  const char *keys_end_ = nullptr;    ///< End of the key block
+  const char *values_ = nullptr;      ///< Start of the value block
+  uint64_t values_size_ = 0;          ///< Size of the value block
+  const Restart *restarts_ = nullptr; ///< Sparse index
+  size_t restart_count_ = 0;          ///< Number of index entries
+
+  /**
+   * @brief Decodes a key entry, updating the previous key into this one.
+   * @param position Start of the entry
+   * @param key Previous key on input, key of the entry on output
+   * @param value_size Output parameter for length of the value
+   * @return Start of the next entry
+   * @throw std::runtime\_error if the entry leaves the key block
+   */
+  const char *DecodeEntry(const char *position, std::string &key,
+                          uint64_t &value_size) const;
+
+  /**
+   * @brief Returns a value of the value block.
+   * @param offset Offset of the value
+   * @param size Length of the value
+   * @throw std::runtime\_error if the value leaves the value block
+   */
+  std::string_view ValueAt(uint64_t offset, uint64_t size) const;
+
+  /**
+   * @brief Returns the whole key that starts a restart group.
+   * @param restart Index of the group
+   */
+  std::string_view RestartKey(size_t restart) const;
+};
+
+/**
+ * @brief Writes word pairs given in increasing order into a dictionary
+ * file.
+ *
+ * Blocks are collected in memory and written by Finish into a temporary
+ * file, which then replaces the target. A process opening the target
+ * meanwhile sees either the old file or the new one.
+ *
+ * @code
+ * BinaryDictionary::Writer writer("words.sst");
+ * writer.Add("apple", "яблоко");
+ * writer.Add("hello", "привет");
+ * writer.Finish();
+ * @endcode
+ */
+class BinaryDictionary::Writer {
+public:
+  /**
+   * @brief Creates a writer, the file is written only by Finish.
+   * @param path Path of the dictionary file
+   */
+  explicit Writer(std::string path) : path_(std::move(path)) {}
+
+  /**
+   * @brief Appends a word pair.
+   * @param english_word Word greater than every word added before
+   * @param russian_word Its translation
+   * @throw std::invalid\_argument if words are not in increasing order
+   */
+  void Add(std::string_view english_word, std::string_view russian_word);
+
+  /**
+   * @brief Writes the file.
+   * @return true if the file was written, false if writing failed
+   */
+  bool Finish();
+
+private:
+  std::string path_;              ///< Path of the dictionary file
+  std::string keys_;              ///< Key block
+  std::string values_;            ///< Value block
+  std::vector<Restart> restarts_; ///< Sparse index
+  std::string last_key_;          ///< Last added English word
+  size_t size_ = 0;               ///< Number of added pairs
+};
+
+#endif // BINARY_DICTIONARY_H
@@ -8,37 +8,258 @@
 #ifndef BINARY_SEARCH_TREE_HPP
 #define BINARY_SEARCH_TREE_HPP
 
+#include "node_allocators.hpp"
+#include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Balancing policy: plain binary search tree without rebalancing.
+ *
+ * Tree shape depends only on insertion order, so sorted input degrades
+ * the tree to a linked list with O(n) operations.
+ */
+struct NoBalancing {};
+
+/**
+ * @brief Balancing policy: AVL tree.
+ *
+ * Keeps heights of sibling subtrees within one of each other, so insertion,
+ * deletion and lookup are guaranteed O(log n) regardless of input order.
+ */
+struct AvlBalancing {};
+
+/**
+ * @brief Balancing policy: splay tree.
+ *
+ * Every lookup and insertion rotates the reached node up to the root, so
+ * frequently accessed keys stay near the top. Operations are amortized
+ * O(log n), and for skewed access, e.g. word frequencies following Zipf's
+ * law, a lookup costs about the entropy of the distribution rather than
+ * log n.
+ *
+ * Find and Contains restructure the tree although they are const, so a
+ * tree with this policy must not be read from several threads at once.
+ */
+struct SplayBalancing {};
+
+/**
+ * @brief Augmentation policy: nodes store nothing besides links and height.
+ */
+struct NoOrderStatistics {};
+
+/**
+ * @brief Augmentation policy: every node stores the size of its subtree.
+ *
+ * Costs one size\_t per node and O(log n) extra work per modification,
+ * enables Select, Rank and CountRange in O(log n) with AvlBalancing.
+ */
+struct OrderStatistics {};
+
+/**
+ * @brief Statistics policy: nothing is counted.
+ *
+ * Lookups compile to the same code as without the policy and the tree
+ * object keeps its size.
+ */
+struct NoStatistics {};
+
+/**
+ * @brief Statistics policy: the tree counts lookups and key comparisons.
+ *
+ * Adds four counters to the tree object and an increment per comparison.
+ * Counters are updated by const lookups too, so a tree with this policy
+ * must not be read from several threads at once.
+ */
+struct CollectStatistics {};
+
+/**
+ * @brief Shape, memory and search statistics of a tree.
+ *
+ * Depth of a node is the number of nodes on the path from the root to it,
+ * so the root has depth 1 and the maximum depth equals the tree height.
+ */
+struct TreeStatistics {
+  size_t size = 0;            ///< Number of elements
+  size_t max_depth = 0;       ///< Depth of the deepest node
+  double average_depth = 0.0; ///< Mean depth over all nodes
+  /// Element d is the number of nodes at depth d + 1
+  std::vector<size_t> depth_histogram;
+  size_t node_size = 0;  ///< Bytes per node, links and key-value pair
+  size_t node_bytes = 0; ///< Bytes of all nodes, without heap data of keys
+  size_t find_calls = 0; ///< Lookups by key, CollectStatistics only
+  size_t find_comparisons = 0;   ///< Key comparisons made by lookups
+  size_t insert_calls = 0;       ///< Searches for an insertion position
+  size_t insert_comparisons = 0; ///< Key comparisons made by those searches
+};
 
 /**
  * @brief Template class implementing a binary search tree data structure.
  *
- * This class provides a key-value storage with O(log n) average time complexity
- * for insertion, deletion, and lookup operations. Keys must support comparison
- * operators (< and ==).
+ * This class provides a key-value storage with insertion, deletion, and
+ * lookup operations. With the default AvlBalancing policy all of them are
+ * guaranteed O(log n); with NoBalancing they are O(log n) on average and O(n)
+ * in the worst case; with SplayBalancing they are amortized O(log n) and
+ * adapt to skewed access. Keys are ordered by Compare, std::less<> by
+ * default.
+ *
+ * If Compare is transparent (has is_transparent member type, as std::less<>
+ * does), Find, Contains, Erase and bound queries accept any type comparable
+ * with KeyType, e.g. std::string_view for std::string keys, without
+ * constructing a temporary key.
  *
  * @tparam KeyType Type of keys stored in the tree
  * @tparam ValueType Type of values associated with keys and stored in the tree
+ * @tparam BalancingPolicy AvlBalancing (default), NoBalancing or
+ * SplayBalancing
+ * @tparam NodeAllocationPolicy HeapNodeAllocation (default) or
+ * PoolNodeAllocation
+ * @tparam Compare Strict weak ordering of keys
+ * @tparam AugmentationPolicy NoOrderStatistics (default) or OrderStatistics
+ * @tparam StatisticsPolicy NoStatistics (default) or CollectStatistics
  */
-template <typename KeyType, typename ValueType>
+template <typename KeyType, typename ValueType,
+          typename BalancingPolicy = AvlBalancing,
+          typename NodeAllocationPolicy = HeapNodeAllocation,
+          typename Compare = std::less<>,
+          typename AugmentationPolicy = NoOrderStatistics,
+          typename StatisticsPolicy = NoStatistics>
 class BinarySearchTree {
+  struct Node;
+
 public:
+  /**
+   * @brief Bidirectional iterator over elements in ascending key order.
+   *
+   * Dereferences to std::pair<const KeyType, ValueType>. Iterators stay
+   * valid until the element they point to is erased.
+   *
+   * @tparam kIsConst true for read-only iterator
+   */
+  template <bool kIsConst> class IteratorBase {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<const KeyType, ValueType>;
+    using difference_type = std::ptrdiff_t;
+    using pointer =
+        std::conditional_t<kIsConst, const value_type *, value_type *>;
+    using reference =
+        std::conditional_t<kIsConst, const value_type &, value_type &>;
+
+    /**
+     * @brief Default constructor. Creates a singular iterator.
+     */
+    IteratorBase() = default;
+
+    /**
+     * @brief Converts mutable iterator to const iterator.
+     * @param other Mutable iterator
+     */
+    template <bool kOtherIsConst,
+              typename = std::enable_if_t<kIsConst && !kOtherIsConst>>
+    IteratorBase(const IteratorBase<kOtherIsConst> &other)
+        : node_(other.node_), tree_(other.tree_) {}
+
+    reference operator*() const { return node_->data; }
+    pointer operator->() const { return &node_->data; }
+
+    /**
+     * @brief Moves to the next key in ascending order.
+     * @return Reference to this iterator
+     */
+    IteratorBase &operator++() {
+      node_ = Successor(node_);
+      return *this;
+    }
+    IteratorBase operator++(int) {
+      IteratorBase old = *this;
+      ++*this;
+      return old;
+    }
+
+    /**
+     * @brief Moves to the previous key, end() moves to the largest key.
+     * @return Reference to this iterator
+     */
+    IteratorBase &operator--() {
+      node_ = node_ ? Predecessor(node_) : Rightmost(tree_->root_);
+      return *this;
+    }
+    IteratorBase operator--(int) {
+      IteratorBase old = *this;
+      --*this;
+      return old;
+    }
+
+    template <bool kOtherIsConst>
+    bool operator==(const IteratorBase<kOtherIsConst> &other) const {
+      return node_ == other.node_;
+    }
+    template <bool kOtherIsConst>
+    bool operator!=(const IteratorBase<kOtherIsConst> &other) const {
+      return node_ != other.node_;
+    }
+
+  private:
+    friend class BinarySearchTree;
+    template <bool> friend class IteratorBase;
+
+    IteratorBase(Node *node, const BinarySearchTree *tree)
+        : node_(node), tree_(tree) {}
+
+    Node *node_ = nullptr;                   ///< Current node, nullptr at end
+    const BinarySearchTree *tree_ = nullptr; ///< Tree for decrementing end
+  };
+  using iterator = IteratorBase<false>;      ///< Mutable iterator
+  using const_iterator = IteratorBase<true>; ///< Read-only iterator
+
   /**
    * @brief Default constructor. Creates an empty tree
    */
   BinarySearchTree() = default;
 
+  /**
+   * @brief Creates an empty tree taking memory from a resource.
+   *
+   * Requires PoolNodeAllocation policy. Nodes, and keys and values that
+   * use polymorphic allocators, e.g. std::pmr::string, are allocated from
+   * the resource. Copies of the tree and trees split from it use it too.
+   *
+   * @param resource Memory resource that outlives the tree
+   * @code
+   * std::pmr::monotonic_buffer_resource buffer;
+   * BinarySearchTree<std::pmr::string, std::pmr::string, AvlBalancing,
+   *                  PoolNodeAllocation> glossary(&buffer);
+   * glossary.Insert("hello", "привет"); // no heap allocations
+   * @endcode
+   */
+  explicit BinarySearchTree(std::pmr::memory_resource *resource)
+      : allocator_(resource) {}
+
   /**
    * @brief Copy constructor. Performs deep copy of another tree.
+   *
+   * With PoolNodeAllocation the copy uses the memory resource of other.
+   *
    * @param other Tree to copy from
    */
   BinarySearchTree(const BinarySearchTree &other)
-      : root_(CopyHelper(other.root_)), size_(other.size_) {}
+      : BinarySearchTree(other, other.allocator_) {}
 
   /**
    * @brief Copy assignment operator. Replaces current tree with a copy of
    * another.
+   *
+   * With PoolNodeAllocation the tree keeps its own memory resource.
+   *
    * @param other Tree to copy from
    * @return Reference to this tree
    */
@@ -46,17 +267,46 @@ public:
     if (this == &other) {
       return *this;
     }
-    Node *copied = CopyHelper(other.root_);
-    ClearHelper(root_);
-    root_ = copied;
-    size_ = other.size_;
+    BinarySearchTree copied(other, allocator_);
+    Swap(copied);
+    return *this;
+  }
+
+  /**
+   * @brief Move constructor. Takes nodes of another tree in O(1).
+   * @param other Tree to move from, left empty
+   */
+  BinarySearchTree(BinarySearchTree &&other) noexcept { Swap(other); }
+
+  /**
+   * @brief Move assignment operator. Takes nodes of another tree.
+   * @param other Tree to move from, left empty
+   * @return Reference to this tree
+   */
+  BinarySearchTree &operator=(BinarySearchTree &&other) noexcept {
+    if (this != &other) {
+      Clear();
+      Swap(other);
+    }
     return *this;
   }
 
   /**
    * @brief Destructor. Deallocates all nodes in the tree.
    */
-  ~BinarySearchTree() { ClearHelper(root_); }
+  ~BinarySearchTree() { DestroyAll(); }
+
+  /**
+   * @brief Exchanges contents of two trees in O(1).
+   * @param other Tree to swap with
+   */
+  void Swap(BinarySearchTree &other) noexcept {
+    std::swap(compare_, other.compare_);
+    std::swap(counters_, other.counters_);
+    std::swap(root_, other.root_);
+    std::swap(size_, other.size_);
+    allocator_.Swap(other.allocator_);
+  }
 
   /**
    * @brief Access or insert element by key (non-const version).
@@ -68,12 +318,16 @@ public:
    * @return Reference to the value associated with the key
    */
   ValueType &operator[](const KeyType &key) {
-    Node *node = FindNode(key);
-    if (!node) {
-      ValueType default_value{};
-      node = InsertHelper(key, default_value);
-    }
-    return node->value;
+    return TryEmplace(key).first->second;
+  }
+
+  /**
+   * @brief Access or insert element by key, moving the key into a new node.
+   * @param key Key to find, change or insert
+   * @return Reference to the value associated with the key
+   */
+  ValueType &operator[](KeyType &&key) {
+    return TryEmplace(std::move(key)).first->second;
   }
 
   /**
@@ -88,22 +342,30 @@ public:
     if (!found) {
       throw std::out_of_range("Key not found");
     }
-    return found->value;
+    return found->data.second;
   }
 
   /**
    * @brief Equality comparison operator.
    *
-   * Two trees are equal if they have the same structure and all
-   * corresponding nodes have equal keys and values.
+   * Two trees are equal if they contain equal keys with equal values.
+   * Shape of the trees is not compared: the same elements inserted in
+   * different order or bulk-built with AssignSorted compare equal.
    *
    * @param other Tree to compare with
    * @return true if trees are equal, false otherwise
    */
   bool operator==(const BinarySearchTree &other) const {
+    if (this == &other)
+      return true;
     if (size_ != other.size_)
       return false;
-    return EqualsHelper(root_, other.root_);
+    for (auto it = begin(), other_it = other.begin(); it != end();
+         ++it, ++other_it) {
+      if (!(it->first == other_it->first && it->second == other_it->second))
+        return false;
+    }
+    return true;
   }
 
   /**
@@ -130,16 +392,204 @@ public:
     return size_ > old_size;
   }
 
+  /**
+   * @brief Inserts a key-value pair, moving them into the tree.
+   *
+   * The key is moved into a new node only if it is not present yet,
+   * the value is moved either into the new node or over the old value.
+   *
+   * @param key Key to insert
+   * @param value Value to associate with the key
+   * @return true if new element was inserted, false if existing was updated
+   */
+  bool Insert(KeyType &&key, ValueType &&value) {
+    size_t old_size = size_;
+    InsertHelper(std::move(key), std::move(value));
+    return size_ > old_size;
+  }
+
+  /**
+   * @brief Constructs an element in place if its key is not present.
+   *
+   * The node is built from args before the key is known, so it is
+   * allocated even if the key already exists. Existing value is kept.
+   *
+   * @param args Arguments for std::pair<const KeyType, ValueType>
+   * @return Iterator to the element with the key and true if it was inserted
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> Emplace(Args &&...args) {
+    Node *node = allocator_.Create(std::forward<Args>(args)...);
+    Node *parent = nullptr;
+    bool is_left = false;
+    Node *existing = FindInsertPosition(node->data.first, parent, is_left);
+    if (existing) {
+      allocator_.Destroy(node);
+      return {iterator(existing, this), false};
+    }
+    LinkNode(node, parent, is_left);
+    return {iterator(node, this), true};
+  }
+
+  /**
+   * @brief Constructs value in place if key is not present.
+   *
+   * Unlike Emplace, nothing is allocated or moved from when key exists.
+   *
+   * @param key Key of the element
+   * @param args Arguments for ValueType constructor
+   * @return Iterator to the element with the key and true if it was inserted
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> TryEmplace(const KeyType &key, Args &&...args) {
+    return TryEmplaceHelper(key, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Constructs value in place if key is not present, moving the key.
+   * @param key Key of the element, moved from only if it is inserted
+   * @param args Arguments for ValueType constructor
+   * @return Iterator to the element with the key and true if it was inserted
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> TryEmplace(KeyType &&key, Args &&...args) {
+    return TryEmplaceHelper(std::move(key), std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Replaces contents with elements of a range sorted by key.
+   *
+   * Builds a perfectly balanced tree in O(n) without any comparisons
+   * against existing nodes. For equal keys the last element of the range
+   * wins. Elements are copied, or moved if first and last are
+   * std::move_iterator.
+   *
+   * @tparam ForwardIt Forward iterator to std::pair<KeyType, ValueType>
+   * @param first Beginning of the range
+   * @param last End of the range
+   * @throw std::invalid_argument if the range is not sorted by key
+   */
+  template <typename ForwardIt>
+  void AssignSorted(ForwardIt first, ForwardIt last) {
+    std::vector<ForwardIt> unique_items;
+    for (ForwardIt it = first; it != last; ++it) {
+      if (!unique_items.empty()) {
+        const auto &previous_key = (*unique_items.back()).first;
+        if (compare_((*it).first, previous_key)) {
+          throw std::invalid_argument("AssignSorted: range is not sorted");
+        }
+        if (!compare_(previous_key, (*it).first)) {
+          unique_items.back() = it;
+          continue;
+        }
+      }
+      unique_items.push_back(it);
+    }
+    BinarySearchTree built(compare_, allocator_);
+    built.allocator_.Reserve(unique_items.size());
+    built.BuildHelper(built.root_, nullptr, unique_items.data(),
+                      unique_items.size());
+    built.size_ = unique_items.size();
+    Swap(built);
+  }
+
+  /**
+   * @brief Replaces contents with elements of an unsorted vector.
+   *
+   * Sorts the elements once, O(n log n), then builds the tree as
+   * AssignSorted does. For equal keys the element that comes last in
+   * the vector wins.
+   *
+   * @param items Key-value pairs in any order, moved into the tree
+   */
+  void Assign(std::vector<std::pair<KeyType, ValueType>> &&items) {
+    std::stable_sort(items.begin(), items.end(),
+                     [this](const auto &first, const auto &second) {
+                       return compare_(first.first, second.first);
+                     });
+    AssignSorted(std::make_move_iterator(items.begin()),
+                 std::make_move_iterator(items.end()));
+  }
+
   /**
    * @brief Searches for a key in the tree.
    * @param key Key to find
    * @return Pointer to value if found, nullptr otherwise
    */
   const ValueType *Find(const KeyType &key) const {
-    Node *found = FindNode(key);
-    if (found)
-      return &found->value;
-    return nullptr;
+    return FindHelper(key);
+  }
+
+  /**
+   * @brief Searches for a key comparable with KeyType.
+   *
+   * Available only for transparent Compare.
+   *
+   * @param key Key to find
+   * @return Pointer to value if found, nullptr otherwise
+   */
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  const ValueType *Find(const K &key) const {
+    return FindHelper(key);
+  }
+
+  /**
+   * @brief Searches for many keys at once, overlapping cache misses.
+   *
+   * Up to kBatchWidth searches descend the tree in turns, one level per
+   * turn, and each prefetches its next node before giving way, so that
+   * the node is in cache when the search comes back to it. A finished
+   * search is replaced by the next key at once. On trees larger than the
+   * cache this hides most of the memory latency of independent lookups.
+   * With SplayBalancing keys are searched one by one.
+   *
+   * @param keys Keys to find
+   * @param count Number of keys
+   * @param results Output array of count pointers to values, nullptr for
+   * absent keys
+   */
+  void FindBatch(const KeyType *keys, size_t count,
+                 const ValueType **results) const {
+    FindBatchHelper(keys, count, results);
+  }
+
+  /**
+   * @brief Searches for many keys comparable with KeyType at once.
+   *
+   * Available only for transparent Compare.
+   *
+   * @param keys Keys to find
+   * @param count Number of keys
+   * @param results Output array of count pointers to values, nullptr for
+   * absent keys
+   */
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  void FindBatch(const K *keys, size_t count,
+                 const ValueType **results) const {
+    FindBatchHelper(keys, count, results);
+  }
+
+  /**
+   * @brief Checks if the tree contains a key.
+   * @param key Key to find
+   * @return true if key is present, false otherwise
+   */
+  bool Contains(const KeyType &key) const { return FindNode(key) != nullptr; }
+
+  /**
+   * @brief Checks if the tree contains a key comparable with KeyType.
+   *
+   * Available only for transparent Compare.
+   *
+   * @param key Key to find
+   * @return true if key is present, false otherwise
+   */
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool Contains(const K &key) const {
+    return FindNode(key) != nullptr;
   }
 
   /**
@@ -147,19 +597,28 @@ public:
    * @param key Key to remove
    * @return true if element was removed, false if key not found
    */
-  bool Erase(const KeyType &key) {
-    bool erased = false;
-    root_ = EraseHelper(root_, key, erased);
-    if (erased)
-      --size_;
-    return erased;
+  bool Erase(const KeyType &key) { return EraseHelper(key); }
+
+  /**
+   * @brief Removes element with a key comparable with KeyType.
+   *
+   * Available only for transparent Compare.
+   *
+   * @param key Key to remove
+   * @return true if element was removed, false if key not found
+   */
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool Erase(const K &key) {
+    return EraseHelper(key);
   }
 
   /**
    * @brief Removes all elements from the tree.
    */
   void Clear() {
-    ClearHelper(root_);
+    DestroyAll();
+    allocator_.Release();
     root_ = nullptr;
     size_ = 0;
   }
@@ -176,6 +635,64 @@ public:
    */
   size_t GetSize() const { return size_; }
 
+  /**
+   * @brief Returns the height of the tree.
+   *
+   * Empty tree has height 0, a single node has height 1.
+   *
+   * @return Number of nodes on the longest root-to-leaf path
+   */
+  size_t GetHeight() const { return HeightHelper(root_); }
+
+  /**
+   * @brief Returns the memory resource of the tree.
+   *
+   * Requires PoolNodeAllocation policy.
+   */
+  std::pmr::memory_resource *GetMemoryResource() const {
+    return allocator_.GetResource();
+  }
+
+  /**
+   * @brief Collects shape and memory statistics of the tree.
+   *
+   * Walks the whole tree in O(n) time and constant stack space. Lookup
+   * counters are filled only with CollectStatistics policy and cover
+   * operations since construction or the last ResetStatistics().
+   *
+   * @return Statistics of the tree
+   */
+  TreeStatistics GetStatistics() const {
+    TreeStatistics statistics;
+    statistics.size = size_;
+    size_t depth_sum = 0;
+    ForEachDepth(root_, [&statistics, &depth_sum](size_t depth) {
+      if (statistics.depth_histogram.size() < depth)
+        statistics.depth_histogram.resize(depth);
+      ++statistics.depth_histogram[depth - 1];
+      depth_sum += depth;
+    });
+    statistics.max_depth = statistics.depth_histogram.size();
+    if (size_ != 0) {
+      statistics.average_depth =
+          static_cast<double>(depth_sum) / static_cast<double>(size_);
+    }
+    statistics.node_size = sizeof(Node);
+    statistics.node_bytes = sizeof(Node) * size_;
+    if constexpr (kStatistics) {
+      statistics.find_calls = counters_.find_calls;
+      statistics.find_comparisons = counters_.find_comparisons;
+      statistics.insert_calls = counters_.insert_calls;
+      statistics.insert_comparisons = counters_.insert_comparisons;
+    }
+    return statistics;
+  }
+
+  /**
+   * @brief Zeroes lookup counters of CollectStatistics policy.
+   */
+  void ResetStatistics() { counters_ = Counters(); }
+
   /**
    * @brief Performs in-order traversal of the tree.
    *
@@ -186,194 +703,1635 @@ public:
    * @param func Callback function to apply to each node
    */
   template <typename Func> void InOrderTraversal(Func func) const {
-    InOrderHelper(root_, func);
+    for (Node *node = Leftmost(root_); node; node = Successor(node))
+      func(node->data.first, node->data.second);
   }
 
-private:
+  iterator begin() { return iterator(Leftmost(root_), this); }
+  const_iterator begin() const {
+    return const_iterator(Leftmost(root_), this);
+  }
+  const_iterator cbegin() const { return begin(); }
+  iterator end() { return iterator(nullptr, this); }
+  const_iterator end() const { return const_iterator(nullptr, this); }
+  const_iterator cend() const { return end(); }
+
   /**
-   * @brief Internal node structure.
+   * @brief Finds the first element whose key is not less than key.
+   * @param key Key to compare with
+   * @return Iterator to the found element or end()
    */
-  struct Node {
-    KeyType key;           ///< Node key
-    ValueType value;       ///< Node value
-    Node *left = nullptr;  ///< Pointer to left child
-    Node *right = nullptr; ///< Pointer to right child
-  };
-  Node *root_ = nullptr; ///< Root node of the tree
-  size_t size_ = 0;      ///< Number of elements in the tree
+  iterator lower_bound(const KeyType &key) {
+    return iterator(LowerBoundNode(key), this);
+  }
+  const_iterator lower_bound(const KeyType &key) const {
+    return const_iterator(LowerBoundNode(key), this);
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K &key) {
+    return iterator(LowerBoundNode(key), this);
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  const_iterator lower_bound(const K &key) const {
+    return const_iterator(LowerBoundNode(key), this);
+  }
 
   /**
-   * @brief Recursively copies a subtree
-   * @param other root of the subtree to copy
-   * @return Pointer to the copied subtree root
+   * @brief Finds the first element whose key is greater than key.
+   * @param key Key to compare with
+   * @return Iterator to the found element or end()
    */
-  Node *CopyHelper(const Node *other) {
-    if (!other)
-      return nullptr;
-    Node *copied = new Node;
-    copied->key = other->key;
-    copied->value = other->value;
-    copied->left = CopyHelper(other->left);
-    copied->right = CopyHelper(other->right);
-    return copied;
+  iterator upper_bound(const KeyType &key) {
+    return iterator(UpperBoundNode(key), this);
+  }
+  const_iterator upper_bound(const KeyType &key) const {
+    return const_iterator(UpperBoundNode(key), this);
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K &key) {
+    return iterator(UpperBoundNode(key), this);
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  const_iterator upper_bound(const K &key) const {
+    return const_iterator(UpperBoundNode(key), this);
   }
 
   /**
-   * @brief Recursively compares two subtrees for equality.
-   * @param node1 Root of first subtree
-   * @param node2 Root of second subtree
-   * @return true if subtrees are equal, false otherwise
+   * @brief Returns range of elements with key equal to key.
+   * @param key Key to compare with
+   * @return Pair of lower_bound(key) and upper_bound(key)
    */
-  bool EqualsHelper(const Node *node1, const Node *node2) const {
-    if (!node1 && !node2)
-      return true;
-    if (!node1 || !node2)
-      return false;
-    return node1->key == node2->key && node1->value == node2->value &&
-           EqualsHelper(node1->left, node2->left) &&
-           EqualsHelper(node1->right, node2->right);
+  std::pair<iterator, iterator> equal_range(const KeyType &key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  std::pair<const_iterator, const_iterator>
+  equal_range(const KeyType &key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K &key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<const_iterator, const_iterator> equal_range(const K &key) const {
+    return {lower_bound(key), upper_bound(key)};
   }
 
   /**
-   * @brief Helper function to insert a node.
-   * @param key Key to insert
-   * @param value Value to insert
-   * @return Pointer to inserted or updated node
+   * @brief Finds the element with given position in ascending key order.
+   *
+   * Requires OrderStatistics policy.
+   *
+   * @param index Zero-based position of the element
+   * @return Iterator to the element, end() if index >= GetSize()
    */
-  Node *InsertHelper(const KeyType &key, const ValueType &value);
+  iterator Select(size_t index) { return iterator(SelectNode(index), this); }
+  const_iterator Select(size_t index) const {
+    return const_iterator(SelectNode(index), this);
+  }
 
   /**
-   * @brief Helper function to find a node by key.
-   * @param key Key to search for
-   * @return Pointer to found node or nullptr
+   * @brief Counts keys less than the given one.
+   *
+   * Requires OrderStatistics policy. The key need not be present; for a
+   * present key the result is its position, so Select(Rank(key)) finds it.
+   *
+   * @param key Key to rank
+   * @return Number of keys less than key
    */
-  Node *FindNode(const KeyType &key) const;
+  size_t Rank(const KeyType &key) const { return RankHelper(key, false); }
 
   /**
-   * @brief Helper function to recursively erase a node.
-   * @param node Current node in recursion
-   * @param key Key to erase
-   * @param erased Output parameter indicating if erasure occurred
-   * @return Pointer to new root of subtree after deletion
+   * @brief Counts keys less than the given one, heterogeneous version.
+   *
+   * Participates in overload resolution only if Compare is transparent.
+   *
+   * @param key Key to rank
+   * @return Number of keys less than key
    */
-  Node *EraseHelper(Node *node, const KeyType &key, bool &erased);
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_t Rank(const K &key) const {
+    return RankHelper(key, false);
+  }
 
   /**
-   * @brief Helper function for in-order traversal.
-   * @tparam Func Function type
-   * @param node Current node
-   * @param func Callback function
+   * @brief Counts keys in the closed range [first, last].
+   *
+   * Requires OrderStatistics policy.
+   *
+   * @param first Smallest key of the range
+   * @param last Largest key of the range
+   * @return Number of keys in the range, 0 if last is less than first
    */
-  template <typename Func> void InOrderHelper(Node *node, Func func) const {
-    if (node) {
-      InOrderHelper(node->left, func);
-      func(node->key, node->value);
-      InOrderHelper(node->right, func);
-    }
+  size_t CountRange(const KeyType &first, const KeyType &last) const {
+    return CountRangeHelper(first, last);
   }
 
   /**
-   * @brief Recursively deallocates a subtree.
-   * @param node Root of subtree to clear
+   * @brief Counts keys in the closed range, heterogeneous version.
+   *
+   * Participates in overload resolution only if Compare is transparent.
+   *
+   * @param first Smallest key of the range
+   * @param last Largest key of the range
+   * @return Number of keys in the range, 0 if last is less than first
    */
-  void ClearHelper(Node *node) {
-    if (node == nullptr)
-      return;
-    ClearHelper(node->left);
-    ClearHelper(node->right);
-    delete node;
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_t CountRange(const K &first, const K &last) const {
+    return CountRangeHelper(first, last);
   }
-};
-
-// Template method implementations
 
-template <typename KeyType, typename ValueType>
-typename BinarySearchTree<KeyType, ValueType>::Node *
-BinarySearchTree<KeyType, ValueType>::InsertHelper(const KeyType &key,
-                                                   const ValueType &value) {
-  if (!root_) {
-    root_ = new Node{key, value};
-    ++size_;
-    return root_;
-  }
-  Node *current = root_;
-  Node *parent = nullptr;
-  while (current) {
-    if (key == current->key) {
-      current->value = value;
-      return current;
-    } else if (key < current->key) {
-      parent = current;
-      current = current->left;
-    } else {
-      parent = current;
-      current = current->right;
-    }
-  }
-  Node *added_node = new Node{key, value};
-  if (key < parent->key) {
-    parent->left = added_node;
-  } else {
-    parent->right = added_node;
-  }
-  ++size_;
-  return added_node;
-}
-template <typename KeyType, typename ValueType>
-typename BinarySearchTree<KeyType, ValueType>::Node *
-BinarySearchTree<KeyType, ValueType>::FindNode(const KeyType &key) const {
-  Node *current = root_;
-  while (current) {
-    if (key == current->key) {
-      return current;
-    } else if (key < current->key) {
-      current = current->left;
-    } else {
-      current = current->right;
+  /**
+   * @brief Reports differences from this tree to another in O(n + m).
+   *
+   * Both trees are walked once in merged key order. Callbacks receive
+   * references to the stored keys and values, nothing is copied.
+   *
+   * @tparam OnAdded Function type with signature void(const KeyType&, const
+   * ValueType&)
+   * @tparam OnRemoved Function type with signature void(const KeyType&,
+   * const ValueType&)
+   * @tparam OnChanged Function type with signature void(const KeyType&,
+   * const ValueType&, const ValueType&)
+   * @param other Tree to compare with
+   * @param on_added Called for keys present only in other, with other's
+   * value
+   * @param on_removed Called for keys present only in this tree
+   * @param on_changed Called for common keys with unequal values, with own
+   * and other's value
+   */
+  template <typename OnAdded, typename OnRemoved, typename OnChanged>
+  void Diff(const BinarySearchTree &other, OnAdded on_added,
+            OnRemoved on_removed, OnChanged on_changed) const {
+    if (this == &other)
+      return;
+    Node *mine = Leftmost(root_);
+    Node *theirs = Leftmost(other.root_);
+    while (mine || theirs) {
+      if (!theirs ||
+          (mine && compare_(mine->data.first, theirs->data.first))) {
+        on_removed(mine->data.first, mine->data.second);
+        mine = Successor(mine);
+      } else if (!mine || compare_(theirs->data.first, mine->data.first)) {
+        on_added(theirs->data.first, theirs->data.second);
+        theirs = Successor(theirs);
+      } else {
+        if (!(mine->data.second == theirs->data.second)) {
+          on_changed(mine->data.first, mine->data.second,
+                     theirs->data.second);
+        }
+        mine = Successor(mine);
+        theirs = Successor(theirs);
+      }
     }
   }
-  return nullptr;
-}
-template <typename KeyType, typename ValueType>
-typename BinarySearchTree<KeyType, ValueType>::Node *
-BinarySearchTree<KeyType, ValueType>::EraseHelper(Node *node,
-                                                  const KeyType &key,
-                                                  bool &erased) {
-  if (node == nullptr)
-    return nullptr;
-  if (key < node->key) {
-    node->left = EraseHelper(node->left, key, erased);
-  } else if (key > node->key) {
-    node->right = EraseHelper(node->right, key, erased);
-  } else {
-    erased = true;
-    Node *swap_node = node->right;
-    if (!node->left) {
-      delete node;
-      return swap_node;
-    }
-    if (!node->right) {
-      swap_node = node->left;
-      delete node;
-      return swap_node;
-    }
-    Node *swap_node_parent = node;
-    while (swap_node->left) {
-      swap_node_parent = swap_node;
-      swap_node = swap_node->left;
-    }
-    if (swap_node == node->right) {
-      swap_node->left = node->left;
-      delete node;
-      return swap_node;
-    }
-    swap_node_parent->left = swap_node->right;
-    swap_node->left = node->left;
-    swap_node->right = node->right;
-    delete node;
-    return swap_node;
-  }
-  return node;
-}
+
+  /**
+   * @brief Moves elements with keys not less than key to a new tree.
+   *
+   * Nodes are relinked, not copied: O(log n) with OrderStatistics policy,
+   * otherwise counting sizes of the parts adds O(min(left, right)). With
+   * PoolNodeAllocation both trees keep using the same slabs.
+   *
+   * @param key Smallest key that goes to the returned tree
+   * @return Tree with all elements whose keys are >= key
+   */
+  BinarySearchTree Split(const KeyType &key) { return SplitOff(key); }
+
+  /**
+   * @brief Moves elements with keys not less than key to a new tree,
+   * heterogeneous version.
+   *
+   * Participates in overload resolution only if Compare is transparent.
+   *
+   * @param key Smallest key that goes to the returned tree
+   * @return Tree with all elements whose keys are >= key
+   */
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  BinarySearchTree Split(const K &key) {
+    return SplitOff(key);
+  }
+
+  /**
+   * @brief Appends all elements of a tree with greater keys in O(log n).
+   *
+   * Nodes of right are relinked into this tree, right is left empty.
+   *
+   * @param right Tree whose keys are all greater than keys of this tree
+   * @throw std::invalid\_argument if some key of right is not greater
+   */
+  void Join(BinarySearchTree &&right) {
+    if (!right.root_)
+      return;
+    if (root_ &&
+        !compare_(Rightmost(root_)->data.first,
+                  Leftmost(right.root_)->data.first)) {
+      throw std::invalid_argument("Join: keys of right tree must be greater");
+    }
+    allocator_.Absorb(right.allocator_);
+    Node *middle = Leftmost(right.root_);
+    right.UnlinkNode(middle);
+    root_ = JoinHelper(root_, middle, right.root_);
+    size_ += right.size_;
+    right.root_ = nullptr;
+    right.size_ = 0;
+  }
+
+  /**
+   * @brief Adds all elements of another tree, its values win on equal keys.
+   *
+   * Join-based: this tree is split by keys of other, so for balanced
+   * policies merging m elements into n takes O(m log(n / m + 1)) plus
+   * copying the added elements. Without balancing splits follow the
+   * shapes of both trees. Recursion is replaced by a stack in the heap,
+   * so trees of any height are merged.
+   *
+   * @param other Tree to add elements from
+   */
+  void Union(const BinarySearchTree &other) {
+    Union(other, [](ValueType &value, const ValueType &other_value) {
+      value = other_value;
+    });
+  }
+
+  /**
+   * @brief Adds all elements of another tree resolving equal keys.
+   *
+   * If resolve throws, or copying an element does, the tree stays valid
+   * and holds part of the union.
+   *
+   * @tparam Resolve Function type with signature void(ValueType&, const
+   * ValueType&)
+   * @param other Tree to add elements from
+   * @param resolve Called with own and other's value for every common key
+   */
+  template <typename Resolve>
+  void Union(const BinarySearchTree &other, Resolve resolve) {
+    Union(other, resolve, [](std::pair<const KeyType, ValueType> &) {});
+  }
+
+  /**
+   * @brief Adds all elements of another tree resolving equal keys and
+   * reporting added elements.
+   *
+   * Nodes already in the tree are kept, only their values are resolved,
+   * so pointers to them stay valid.
+   *
+   * @tparam Resolve Function type with signature void(ValueType&, const
+   * ValueType&)
+   * @tparam OnAdded Function type with signature
+   * void(std::pair<const KeyType, ValueType>&)
+   * @param other Tree to add elements from
+   * @param resolve Called with own and other's value for every common key
+   * @param on_added Called with every copied element, must not throw
+   */
+  template <typename Resolve, typename OnAdded>
+  void Union(const BinarySearchTree &other, Resolve resolve,
+             OnAdded on_added) {
+    if (this == &other)
+      return;
+    size_t added = 0;
+    try {
+      UnionHelper(root_, other.root_, resolve, on_added, added);
+    } catch (...) {
+      size_ += added;
+      throw;
+    }
+    size_ += added;
+  }
+
+  /**
+   * @brief Keeps only elements whose keys are present in another tree.
+   *
+   * Runs in O(m log(n / m + 1)) for balanced policies plus destroying
+   * the removed elements. Trees of any height are handled as by Union.
+   *
+   * @param other Tree with keys to keep, its values are ignored
+   */
+  void Intersection(const BinarySearchTree &other) {
+    if (this == &other)
+      return;
+    size_t removed = 0;
+    IntersectionHelper(root_, other.root_, removed);
+    size_ -= removed;
+  }
+
+  /**
+   * @brief Removes all elements whose keys are present in another tree.
+   *
+   * Runs in O(m log(n / m + 1)) for balanced policies. Trees of any
+   * height are handled as by Union.
+   *
+   * @param other Tree with keys to remove, its values are ignored
+   */
+  void Difference(const BinarySearchTree &other) {
+    if (this == &other) {
+      Clear();
+      return;
+    }
+    size_t removed = 0;
+    DifferenceHelper(root_, other.root_, removed);
+    size_ -= removed;
+  }
+
+private:
+  /// true if the tree restores AVL invariant after modifications
+  static constexpr bool kAvl = std::is_same_v<BalancingPolicy, AvlBalancing>;
+  /// Number of searches FindBatch runs at once, enough to cover memory
+  /// latency with a few dozen cycles of work per tree level each
+  static constexpr size_t kBatchWidth = 16;
+  /// true if accessed nodes are splayed to the root
+  static constexpr bool kSplay =
+      std::is_same_v<BalancingPolicy, SplayBalancing>;
+  /// true if nodes store sizes of their subtrees
+  static constexpr bool kOrderStatistics =
+      std::is_same_v<AugmentationPolicy, OrderStatistics>;
+  /// true if lookups count key comparisons
+  static constexpr bool kStatistics =
+      std::is_same_v<StatisticsPolicy, CollectStatistics>;
+
+  /**
+   * @brief Lookup counters of CollectStatistics policy.
+   */
+  struct StatisticsCounters {
+    size_t find_calls = 0;         ///< Calls of FindNode
+    size_t find_comparisons = 0;   ///< Key comparisons in FindNode
+    size_t insert_calls = 0;       ///< Calls of FindInsertPosition
+    size_t insert_comparisons = 0; ///< Key comparisons in FindInsertPosition
+  };
+  struct NoStatisticsCounters {};
+  using Counters = std::conditional_t<kStatistics, StatisticsCounters,
+                                      NoStatisticsCounters>;
+
+  /**
+   * @brief Subtree size stored in nodes with OrderStatistics policy.
+   */
+  struct SubtreeSizeField {
+    size_t subtree_size = 1; ///< Number of nodes in the subtree
+  };
+  struct NoSubtreeSizeField {};
+
+  /**
+   * @brief Internal node structure.
+   */
+  struct Node : std::conditional_t<kOrderStatistics, SubtreeSizeField,
+                                    NoSubtreeSizeField> {
+    /**
+     * @brief Constructs node data from the arguments, links are empty.
+     * @param args Arguments forwarded to the key-value pair constructor
+     */
+    template <typename... Args>
+    explicit Node(Args &&...args) : data(std::forward<Args>(args)...) {}
+
+    std::pair<const KeyType, ValueType> data; ///< Node key and value
+    Node *left = nullptr;   ///< Pointer to left child
+    Node *right = nullptr;  ///< Pointer to right child
+    Node *parent = nullptr; ///< Pointer to parent, nullptr for the root
+    int height = 1;         ///< Height of the subtree rooted at this node
+  };
+  Compare compare_;      ///< Ordering of keys
+  /// Lookup counters, empty without CollectStatistics, so that together
+  /// with an empty Compare it fits into padding before root_
+  mutable Counters counters_;
+  /// Root node of the tree, mutable because SplayBalancing lookups
+  /// change it
+  mutable Node *root_ = nullptr;
+  size_t size_ = 0;      ///< Number of elements in the tree
+  /// Allocator of nodes chosen by NodeAllocationPolicy
+  using Allocator = typename NodeAllocationPolicy::template Allocator<Node>;
+  Allocator allocator_; ///< Source of tree nodes
+
+  /**
+   * @brief Creates an empty tree with given ordering and node source.
+   * @param compare Ordering of keys
+   * @param allocator Allocator to copy, with PoolNodeAllocation its
+   * memory resource is used
+   */
+  BinarySearchTree(const Compare &compare, const Allocator &allocator)
+      : compare_(compare), allocator_(allocator) {}
+
+  /**
+   * @brief Deep copy of a tree using given node source.
+   * @param other Tree to copy from
+   * @param allocator Allocator to copy, with PoolNodeAllocation its
+   * memory resource is used
+   */
+  BinarySearchTree(const BinarySearchTree &other, const Allocator &allocator)
+      : BinarySearchTree(other.compare_, allocator) {
+    allocator_.Reserve(other.size_);
+    root_ = CopyHelper(other.root_, nullptr);
+    size_ = other.size_;
+  }
+
+  /**
+   * @brief Copies a subtree in constant stack space.
+   *
+   * Source and copy are walked in lockstep in preorder, parent pointers
+   * lead back up. If copying a node throws, the partial copy is destroyed.
+   *
+   * @param other Root of the subtree to copy
+   * @param parent Parent for the copied subtree root
+   * @return Pointer to the copied subtree root
+   */
+  Node *CopyHelper(const Node *other, Node *parent) {
+    if (!other)
+      return nullptr;
+    Node *root = CopyNode(other, parent);
+    try {
+      const Node *source = other;
+      Node *target = root;
+      while (true) {
+        if (source->left && !target->left) {
+          target->left = CopyNode(source->left, target);
+          source = source->left;
+          target = target->left;
+        } else if (source->right && !target->right) {
+          target->right = CopyNode(source->right, target);
+          source = source->right;
+          target = target->right;
+        } else if (source != other) {
+          source = source->parent;
+          target = target->parent;
+        } else {
+          break;
+        }
+      }
+    } catch (...) {
+      ClearHelper(root);
+      throw;
+    }
+    return root;
+  }
+
+  /**
+   * @brief Copies one node with its stored height and size, without links.
+   * @param other Node to copy
+   * @param parent Parent of the copy
+   * @return Pointer to the copy
+   */
+  Node *CopyNode(const Node *other, Node *parent) {
+    Node *copied = allocator_.Create(other->data.first, other->data.second);
+    copied->parent = parent;
+    copied->height = other->height;
+    if constexpr (kOrderStatistics)
+      copied->subtree_size = other->subtree_size;
+    return copied;
+  }
+
+  /**
+   * @brief Recursively builds perfectly balanced subtree from sorted items.
+   * @param slot Link that receives the subtree root, set before recursion
+   * so a partially built tree stays reachable if construction throws
+   * @param parent Parent of the subtree root
+   * @param items Iterators to elements in ascending key order
+   * @param count Number of items
+   * @return Height of the built subtree
+   */
+  template <typename Iterator>
+  int BuildHelper(Node *&slot, Node *parent, const Iterator *items,
+                  size_t count) {
+    if (count == 0)
+      return 0;
+    size_t middle = count / 2;
+    slot = allocator_.Create(*items[middle]);
+    slot->parent = parent;
+    if constexpr (kOrderStatistics)
+      slot->subtree_size = count;
+    int left = BuildHelper(slot->left, slot, items, middle);
+    int right = BuildHelper(slot->right, slot, items + middle + 1,
+                            count - middle - 1);
+    slot->height = 1 + (left > right ? left : right);
+    return slot->height;
+  }
+
+  /**
+   * @brief Helper function to insert a node or assign existing value.
+   * @param key Key to insert, forwarded into a new node
+   * @param value Value to insert, forwarded into the node
+   * @return Pointer to inserted or updated node
+   */
+  template <typename K, typename V> Node *InsertHelper(K &&key, V &&value) {
+    Node *parent = nullptr;
+    bool is_left = false;
+    Node *existing = FindInsertPosition(key, parent, is_left);
+    if (existing) {
+      existing->data.second = std::forward<V>(value);
+      return existing;
+    }
+    Node *added_node =
+        allocator_.Create(std::forward<K>(key), std::forward<V>(value));
+    LinkNode(added_node, parent, is_left);
+    return added_node;
+  }
+
+  /**
+   * @brief Helper function to construct value in place for a new key.
+   * @param key Key to insert, forwarded into a new node
+   * @param args Arguments for ValueType constructor
+   * @return Iterator to the element with the key and true if it was inserted
+   */
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> TryEmplaceHelper(K &&key, Args &&...args) {
+    Node *parent = nullptr;
+    bool is_left = false;
+    Node *existing = FindInsertPosition(key, parent, is_left);
+    if (existing)
+      return {iterator(existing, this), false};
+    Node *added_node = allocator_.Create(
+        std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    LinkNode(added_node, parent, is_left);
+    return {iterator(added_node, this), true};
+  }
+
+  /**
+   * @brief Finds a node with key or a place where it should be attached.
+   * @param key Key to search for
+   * @param parent Output parameter for parent of the new node
+   * @param is_left Output parameter, true if new node is the left child
+   * @return Pointer to the node with key or nullptr if key is absent
+   */
+  Node *FindInsertPosition(const KeyType &key, Node *&parent,
+                           bool &is_left) const {
+    Node *current = root_;
+    parent = nullptr;
+    is_left = false;
+    size_t comparisons = 0;
+    while (current) {
+      parent = current;
+      if (CountedLess(key, current->data.first, comparisons)) {
+        current = current->left;
+        is_left = true;
+      } else if (CountedLess(current->data.first, key, comparisons)) {
+        current = current->right;
+        is_left = false;
+      } else {
+        break;
+      }
+    }
+    if constexpr (kStatistics) {
+      ++counters_.insert_calls;
+      counters_.insert_comparisons += comparisons;
+    }
+    // New nodes are splayed by LinkNode
+    if constexpr (kSplay) {
+      if (current)
+        Splay(current);
+    }
+    return current;
+  }
+
+  /**
+   * @brief Attaches new node to the tree and rebalances it.
+   * @param node Node to attach
+   * @param parent Parent from FindInsertPosition, nullptr for empty tree
+   * @param is_left true if node becomes the left child of parent
+   */
+  void LinkNode(Node *node, Node *parent, bool is_left) {
+    node->parent = parent;
+    if (!parent) {
+      root_ = node;
+    } else if (is_left) {
+      parent->left = node;
+    } else {
+      parent->right = node;
+    }
+    ++size_;
+    UpdateSizesToRoot(parent);
+    if constexpr (kSplay) {
+      Splay(node);
+    } else {
+      Rebalance(parent);
+    }
+  }
+
+  /**
+   * @brief Helper function to find value by key.
+   * @param key Key to search for
+   * @return Pointer to value if found, nullptr otherwise
+   */
+  template <typename K> const ValueType *FindHelper(const K &key) const {
+    Node *found = FindNode(key);
+    if (found)
+      return &found->data.second;
+    return nullptr;
+  }
+
+  /**
+   * @brief Helper function for interleaved search of many keys.
+   * @param keys Keys to find
+   * @param count Number of keys
+   * @param results Output array of pointers to values
+   */
+  template <typename K>
+  void FindBatchHelper(const K *keys, size_t count,
+                       const ValueType **results) const {
+    // Splaying moves the nodes other searches are standing on
+    if (kSplay || !root_) {
+      for (size_t index = 0; index < count; ++index)
+        results[index] = FindHelper(keys[index]);
+      return;
+    }
+    Node *nodes[kBatchWidth] = {};    // Next node of every running search
+    size_t queries[kBatchWidth] = {}; // Index of the key of every search
+    size_t running = std::min(count, kBatchWidth);
+    for (size_t slot = 0; slot < running; ++slot) {
+      nodes[slot] = root_;
+      queries[slot] = slot;
+      results[slot] = nullptr;
+    }
+    size_t next_query = running;
+    size_t comparisons = 0;
+    while (running > 0) {
+      for (size_t slot = 0; slot < kBatchWidth; ++slot) {
+        Node *node = nodes[slot];
+        if (!node)
+          continue;
+        const K &key = keys[queries[slot]];
+        Node *next = nullptr;
+        if (CountedLess(key, node->data.first, comparisons)) {
+          next = node->left;
+        } else if (CountedLess(node->data.first, key, comparisons)) {
+          next = node->right;
+        } else {
+          results[queries[slot]] = &node->data.second;
+        }
+        if (next) {
+          Prefetch(next);
+          nodes[slot] = next;
+          continue;
+        }
+        // The search has ended, its slot takes the next key
+        if (next_query < count) {
+          nodes[slot] = root_;
+          queries[slot] = next_query;
+          results[next_query++] = nullptr;
+        } else {
+          nodes[slot] = nullptr;
+          --running;
+        }
+      }
+    }
+    if constexpr (kStatistics) {
+      counters_.find_calls += count;
+      counters_.find_comparisons += comparisons;
+    }
+  }
+
+  /**
+   * @brief Asks the processor to start loading a node into cache.
+   * @param node Node that will be read soon
+   */
+  static void Prefetch(const Node *node) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(node);
+#else
+    (void)node;
+#endif
+  }
+
+  /**
+   * @brief Helper function to erase element by key.
+   * @param key Key to erase
+   * @return true if element was removed, false if key not found
+   */
+  template <typename K> bool EraseHelper(const K &key) {
+    Node *node = FindNode(key);
+    if (!node)
+      return false;
+    EraseNode(node);
+    --size_;
+    return true;
+  }
+
+  /**
+   * @brief Helper function to find a node by key.
+   * @param key Key to search for
+   * @return Pointer to found node or nullptr
+   */
+  template <typename K> Node *FindNode(const K &key) const {
+    Node *current = root_;
+    Node *last = nullptr;
+    size_t comparisons = 0;
+    while (current) {
+      last = current;
+      if (CountedLess(key, current->data.first, comparisons)) {
+        current = current->left;
+      } else if (CountedLess(current->data.first, key, comparisons)) {
+        current = current->right;
+      } else {
+        break;
+      }
+    }
+    if constexpr (kStatistics) {
+      ++counters_.find_calls;
+      counters_.find_comparisons += comparisons;
+    }
+    // A miss splays the last node on the path, so that repeated misses
+    // get cheap too
+    if constexpr (kSplay) {
+      if (last)
+        Splay(current ? current : last);
+    }
+    return current;
+  }
+
+  /**
+   * @brief Compares keys, counting the comparison with CollectStatistics.
+   * @param first Left operand of Compare
+   * @param second Right operand of Compare
+   * @param comparisons Counter to increment, untouched without statistics
+   * @return compare\_(first, second)
+   */
+  template <typename First, typename Second>
+  bool CountedLess(const First &first, const Second &second,
+                   size_t &comparisons) const {
+    if constexpr (kStatistics)
+      ++comparisons;
+    return compare_(first, second);
+  }
+
+  /**
+   * @brief Finds the first node whose key is not less than key.
+   * @param key Key to compare with
+   * @return Found node or nullptr
+   */
+  template <typename K> Node *LowerBoundNode(const K &key) const {
+    Node *current = root_;
+    Node *bound = nullptr;
+    while (current) {
+      if (compare_(current->data.first, key)) {
+        current = current->right;
+      } else {
+        bound = current;
+        current = current->left;
+      }
+    }
+    return bound;
+  }
+
+  /**
+   * @brief Finds the first node whose key is greater than key.
+   * @param key Key to compare with
+   * @return Found node or nullptr
+   */
+  template <typename K> Node *UpperBoundNode(const K &key) const {
+    Node *current = root_;
+    Node *bound = nullptr;
+    while (current) {
+      if (compare_(key, current->data.first)) {
+        bound = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    return bound;
+  }
+
+  /**
+   * @brief Returns node with the smallest key in a subtree.
+   * @param node Root of the subtree, may be nullptr
+   */
+  static Node *Leftmost(Node *node) {
+    while (node && node->left)
+      node = node->left;
+    return node;
+  }
+
+  /**
+   * @brief Returns node with the largest key in a subtree.
+   * @param node Root of the subtree, may be nullptr
+   */
+  static Node *Rightmost(Node *node) {
+    while (node && node->right)
+      node = node->right;
+    return node;
+  }
+
+  /**
+   * @brief Returns in-order successor of a node, nullptr for the last one.
+   */
+  static Node *Successor(Node *node) {
+    if (node->right)
+      return Leftmost(node->right);
+    while (node->parent && node == node->parent->right)
+      node = node->parent;
+    return node->parent;
+  }
+
+  /**
+   * @brief Returns in-order predecessor of a node, nullptr for the first one.
+   */
+  static Node *Predecessor(Node *node) {
+    if (node->left)
+      return Rightmost(node->left);
+    while (node->parent && node == node->parent->left)
+      node = node->parent;
+    return node->parent;
+  }
+
+  /**
+   * @brief Unlinks a node from the tree, deallocates it and rebalances.
+   * @param node Node to erase, must belong to this tree
+   */
+  void EraseNode(Node *node) {
+    UnlinkNode(node);
+    allocator_.Destroy(node);
+  }
+
+  /**
+   * @brief Unlinks a node from the tree and rebalances, keeps the node.
+   *
+   * Links of the unlinked node are left unchanged.
+   *
+   * @param node Node to unlink, must belong to this tree
+   */
+  void UnlinkNode(Node *node) {
+    Node *rebalance_from = nullptr;
+    if (!node->left || !node->right) {
+      Node *child = node->left ? node->left : node->right;
+      rebalance_from = node->parent;
+      ReplaceChild(node->parent, node, child);
+    } else {
+      // Successor takes the place of the node, so nodes are relinked rather
+      // than keys and values being copied
+      Node *successor = node->right;
+      while (successor->left)
+        successor = successor->left;
+      if (successor == node->right) {
+        rebalance_from = successor;
+      } else {
+        rebalance_from = successor->parent;
+        ReplaceChild(successor->parent, successor, successor->right);
+        successor->right = node->right;
+        successor->right->parent = successor;
+      }
+      ReplaceChild(node->parent, node, successor);
+      successor->left = node->left;
+      successor->left->parent = successor;
+      successor->height = node->height;
+    }
+    UpdateSizesToRoot(rebalance_from);
+    Rebalance(rebalance_from);
+  }
+
+  /**
+   * @brief Finds node with given position in ascending key order.
+   * @param index Zero-based position
+   * @return Found node, nullptr if index is out of range
+   */
+  Node *SelectNode(size_t index) const {
+    static_assert(kOrderStatistics, "Select requires OrderStatistics policy");
+    Node *current = root_;
+    while (current) {
+      size_t left_size = SubtreeSize(current->left);
+      if (index < left_size) {
+        current = current->left;
+      } else if (index == left_size) {
+        return current;
+      } else {
+        index -= left_size + 1;
+        current = current->right;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Counts keys less than (or equal to) the given one.
+   * @param key Key to rank
+   * @param inclusive true to also count the key itself if present
+   * @return Number of counted keys
+   */
+  template <typename K> size_t RankHelper(const K &key, bool inclusive) const {
+    static_assert(kOrderStatistics, "Rank requires OrderStatistics policy");
+    size_t rank = 0;
+    Node *current = root_;
+    while (current) {
+      bool goes_right = inclusive ? !compare_(key, current->data.first)
+                                  : compare_(current->data.first, key);
+      if (goes_right) {
+        rank += SubtreeSize(current->left) + 1;
+        current = current->right;
+      } else {
+        current = current->left;
+      }
+    }
+    return rank;
+  }
+
+  /**
+   * @brief Helper function for counting keys in [first, last].
+   * @param first Smallest key of the range
+   * @param last Largest key of the range
+   * @return Number of keys in the range
+   */
+  template <typename K>
+  size_t CountRangeHelper(const K &first, const K &last) const {
+    if (compare_(last, first))
+      return 0;
+    return RankHelper(last, true) - RankHelper(first, false);
+  }
+
+  /**
+   * @brief Deallocates a subtree in constant stack space.
+   *
+   * Left children are rotated up until the root has none, then the root
+   * is destroyed and its right subtree processed the same way, so the
+   * tree is unrolled into a list as it is destroyed. Parent links are not
+   * maintained.
+   *
+   * @tparam kDiscard true if slots are not recycled because the allocator
+   * releases them next
+   * @param node Root of subtree to clear
+   * @return Number of deallocated nodes
+   */
+  template <bool kDiscard = false> size_t ClearHelper(Node *node) {
+    size_t cleared = 0;
+    while (node) {
+      if (node->left) {
+        Node *left = node->left;
+        node->left = left->right;
+        left->right = node;
+        node = left;
+      } else {
+        Node *right = node->right;
+        if constexpr (kDiscard)
+          allocator_.Discard(node);
+        else
+          allocator_.Destroy(node);
+        node = right;
+        ++cleared;
+      }
+    }
+    return cleared;
+  }
+
+  /**
+   * @brief Destroys all nodes before the allocator is released.
+   *
+   * Slots are not put on the free list of a pool. If nodes need no
+   * destructor, a pool frees all of them with its slabs and the tree is
+   * not walked at all.
+   */
+  void DestroyAll() {
+    if constexpr (!Allocator::kReleaseFreesNodes ||
+                  !std::is_trivially_destructible_v<Node>) {
+      ClearHelper<true>(root_);
+    }
+  }
+
+  /**
+   * @brief Computes height of a subtree in constant stack space.
+   *
+   * With AvlBalancing the height is stored, otherwise the subtree is
+   * walked in order following parent links and tracking the depth.
+   *
+   * @param node Root of the subtree
+   * @return Height of the subtree
+   */
+  static size_t HeightHelper(const Node *node) {
+    if (!node)
+      return 0;
+    if constexpr (kAvl) {
+      return static_cast<size_t>(node->height);
+    } else {
+      size_t height = 0;
+      ForEachDepth(node, [&height](size_t depth) {
+        height = std::max(height, depth);
+      });
+      return height;
+    }
+  }
+
+  /**
+   * @brief Reports depth of every node of a subtree in constant stack space.
+   *
+   * The subtree is walked in order following parent links; its root has
+   * depth 1.
+   *
+   * @param node Root of the subtree, may be nullptr
+   * @param func Callback called with the depth of each node
+   */
+  template <typename Func>
+  static void ForEachDepth(const Node *node, Func func) {
+    if (!node)
+      return;
+    const Node *root = node;
+    size_t depth = 1;
+    func(depth);
+    while (node->left) {
+      node = node->left;
+      func(++depth);
+    }
+    while (true) {
+      if (node->right) {
+        node = node->right;
+        func(++depth);
+        while (node->left) {
+          node = node->left;
+          func(++depth);
+        }
+        continue;
+      }
+      while (node != root && node == node->parent->right) {
+        node = node->parent;
+        --depth;
+      }
+      if (node == root)
+        return;
+      node = node->parent;
+      --depth;
+    }
+  }
+
+  /**
+   * @brief Returns stored height of a node, 0 for nullptr.
+   */
+  static int Height(const Node *node) { return node ? node->height : 0; }
+
+  /**
+   * @brief Recomputes stored height of a node from its children.
+   */
+  static void UpdateHeight(Node *node) {
+    int left = Height(node->left);
+    int right = Height(node->right);
+    node->height = 1 + (left > right ? left : right);
+  }
+
+  /**
+   * @brief Returns stored subtree size of a node, 0 for nullptr.
+   */
+  static size_t SubtreeSize(const Node *node) {
+    return node ? node->subtree_size : 0;
+  }
+
+  /**
+   * @brief Recalculates subtree size of a node from its children.
+   */
+  static void UpdateSize(Node *node) {
+    if constexpr (kOrderStatistics) {
+      node->subtree_size =
+          1 + SubtreeSize(node->left) + SubtreeSize(node->right);
+    }
+  }
+
+  /**
+   * @brief Recalculates subtree sizes on the path from a node to the root.
+   *
+   * Called after a node was linked or unlinked below the given one. Unlike
+   * heights, every ancestor's size changes, so the walk can't stop early.
+   *
+   * @param node Lowest node whose subtree changed, may be nullptr
+   */
+  static void UpdateSizesToRoot(Node *node) {
+    if constexpr (kOrderStatistics) {
+      for (; node; node = node->parent)
+        UpdateSize(node);
+    }
+  }
+
+  /**
+   * @brief Replaces child link of parent (or root) pointing to old_child.
+   * @param parent Parent of old_child, nullptr if old_child is the root
+   * @param old_child Child to replace
+   * @param new_child Replacement, may be nullptr
+   */
+  void ReplaceChild(Node *parent, Node *old_child, Node *new_child) {
+    if (!parent)
+      root_ = new_child;
+    LinkChild(parent, old_child, new_child);
+  }
+
+  /**
+   * @brief Replaces child link of parent, doesn't touch the root.
+   *
+   * Used on detached subtrees, where parent is nullptr for the subtree root.
+   *
+   * @param parent Parent of old_child, may be nullptr
+   * @param old_child Child to replace
+   * @param new_child Replacement, may be nullptr
+   */
+  static void LinkChild(Node *parent, Node *old_child, Node *new_child) {
+    if (parent) {
+      if (parent->left == old_child) {
+        parent->left = new_child;
+      } else {
+        parent->right = new_child;
+      }
+    }
+    if (new_child)
+      new_child->parent = parent;
+  }
+
+  /**
+   * @brief Rotates subtree left around node.
+   * @param node Root of the subtree, must have right child
+   * @return New root of the subtree, root\_ is not updated
+   */
+  static Node *RotateLeft(Node *node) {
+    Node *pivot = node->right;
+    node->right = pivot->left;
+    if (pivot->left)
+      pivot->left->parent = node;
+    LinkChild(node->parent, node, pivot);
+    pivot->left = node;
+    node->parent = pivot;
+    UpdateHeight(node);
+    UpdateHeight(pivot);
+    UpdateSize(node);
+    UpdateSize(pivot);
+    return pivot;
+  }
+
+  /**
+   * @brief Rotates subtree right around node.
+   * @param node Root of the subtree, must have left child
+   * @return New root of the subtree, root\_ is not updated
+   */
+  static Node *RotateRight(Node *node) {
+    Node *pivot = node->left;
+    node->left = pivot->right;
+    if (pivot->right)
+      pivot->right->parent = node;
+    LinkChild(node->parent, node, pivot);
+    pivot->right = node;
+    node->parent = pivot;
+    UpdateHeight(node);
+    UpdateHeight(pivot);
+    UpdateSize(node);
+    UpdateSize(pivot);
+    return pivot;
+  }
+
+  /**
+   * @brief Moves a node to the root by splay rotations.
+   *
+   * Zig-zig steps rotate the grandparent first, which roughly halves the
+   * depth of every node on the path and gives the amortized bound.
+   * Const, because lookups splay too; only links and root\_ change.
+   *
+   * @param node Node of this tree
+   */
+  void Splay(Node *node) const {
+    while (Node *parent = node->parent) {
+      Node *grandparent = parent->parent;
+      bool is_left = parent->left == node;
+      if (!grandparent) {
+        is_left ? RotateRight(parent) : RotateLeft(parent);
+      } else if (is_left == (grandparent->left == parent)) {
+        if (is_left) {
+          RotateRight(grandparent);
+          RotateRight(parent);
+        } else {
+          RotateLeft(grandparent);
+          RotateLeft(parent);
+        }
+      } else if (is_left) {
+        RotateRight(parent);
+        RotateLeft(grandparent);
+      } else {
+        RotateLeft(parent);
+        RotateRight(grandparent);
+      }
+    }
+    root_ = node;
+  }
+
+  /**
+   * @brief Restores balance on the path from node to the root.
+   *
+   * With AvlBalancing restores the AVL invariant, with SplayBalancing
+   * splays the node.
+   *
+   * @param node Lowest node whose subtree has changed
+   */
+  void Rebalance(Node *node) {
+    if constexpr (kSplay) {
+      if (node)
+        Splay(node);
+      return;
+    }
+    if constexpr (!kAvl) {
+      return;
+    }
+    while (node) {
+      int old_height = node->height;
+      node = BalanceNode(node);
+      if (!node->parent)
+        root_ = node;
+      // Subtree height unchanged, so ancestors are still balanced
+      if (node->height == old_height)
+        return;
+      node = node->parent;
+    }
+  }
+
+  /**
+   * @brief Updates a node and restores AVL invariant at it.
+   *
+   * Children must be valid subtrees with heights differing by at most two.
+   *
+   * @param node Node to update
+   * @return New root of the subtree, root\_ is not updated
+   */
+  static Node *BalanceNode(Node *node) {
+    UpdateHeight(node);
+    UpdateSize(node);
+    if constexpr (kAvl) {
+      int balance = Height(node->left) - Height(node->right);
+      if (balance > 1) {
+        if (Height(node->left->left) < Height(node->left->right))
+          RotateLeft(node->left);
+        node = RotateRight(node);
+      } else if (balance < -1) {
+        if (Height(node->right->right) < Height(node->right->left))
+          RotateRight(node->right);
+        node = RotateLeft(node);
+      }
+    }
+    return node;
+  }
+
+  /**
+   * @brief Cuts a node off its children, leaving three detached subtrees.
+   * @param node Node to detach
+   * @param left Output parameter for former left subtree
+   * @param right Output parameter for former right subtree
+   */
+  static void Detach(Node *node, Node *&left, Node *&right) {
+    left = node->left;
+    right = node->right;
+    node->left = node->right = node->parent = nullptr;
+    if (left)
+      left->parent = nullptr;
+    if (right)
+      right->parent = nullptr;
+  }
+
+  /**
+   * @brief Makes a detached node the root of two detached subtrees.
+   * @return The node
+   */
+  static Node *Attach(Node *middle, Node *left, Node *right) {
+    middle->left = left;
+    middle->right = right;
+    middle->parent = nullptr;
+    if (left)
+      left->parent = middle;
+    if (right)
+      right->parent = middle;
+    UpdateHeight(middle);
+    UpdateSize(middle);
+    return middle;
+  }
+
+  /**
+   * @brief Joins detached subtrees with keys left < middle < right.
+   *
+   * With AvlBalancing the middle node goes down the spine of the higher
+   * subtree to the height of the other one, so joining takes
+   * O(|height(left) - height(right)| + 1).
+   *
+   * @param left Subtree with smaller keys, may be nullptr
+   * @param middle Detached node
+   * @param right Subtree with greater keys, may be nullptr
+   * @return Root of the joined detached subtree
+   */
+  static Node *JoinHelper(Node *left, Node *middle, Node *right) {
+    if constexpr (kAvl) {
+      if (Height(left) > Height(right) + 1)
+        return JoinRight(left, middle, right);
+      if (Height(right) > Height(left) + 1)
+        return JoinLeft(left, middle, right);
+    }
+    return Attach(middle, left, right);
+  }
+
+  /**
+   * @brief Joins along the right spine of left, which is higher.
+   */
+  static Node *JoinRight(Node *left, Node *middle, Node *right) {
+    Node *inner = left->right;
+    if (inner)
+      inner->parent = nullptr;
+    Node *joined = Height(inner) <= Height(right) + 1
+                       ? Attach(middle, inner, right)
+                       : JoinRight(inner, middle, right);
+    left->right = joined;
+    joined->parent = left;
+    return BalanceNode(left);
+  }
+
+  /**
+   * @brief Joins along the left spine of right, which is higher.
+   */
+  static Node *JoinLeft(Node *left, Node *middle, Node *right) {
+    Node *inner = right->left;
+    if (inner)
+      inner->parent = nullptr;
+    Node *joined = Height(inner) <= Height(left) + 1
+                       ? Attach(middle, left, inner)
+                       : JoinLeft(left, middle, inner);
+    right->left = joined;
+    joined->parent = right;
+    return BalanceNode(right);
+  }
+
+  /**
+   * @brief Joins detached subtrees with keys left < right.
+   * @return Root of the joined detached subtree
+   */
+  static Node *JoinTwo(Node *left, Node *right) {
+    if (!left)
+      return right;
+    if (!right)
+      return left;
+    Node *last = nullptr;
+    Node *rest = SplitLast(left, last);
+    return JoinHelper(rest, last, right);
+  }
+
+  /**
+   * @brief Removes the largest node of a detached subtree.
+   * @param tree Root of non-empty detached subtree
+   * @param last Output parameter for the removed, detached node
+   * @return Root of the remaining detached subtree
+   */
+  static Node *SplitLast(Node *tree, Node *&last) {
+    last = Rightmost(tree);
+    Node *rest = last->left;
+    if (rest)
+      rest->parent = nullptr;
+    // Climb the right spine joining left subtrees with the rest
+    Node *node = last->parent;
+    last->left = last->parent = nullptr;
+    while (node) {
+      Node *up = node->parent;
+      Node *node_left = node->left;
+      if (node_left)
+        node_left->parent = nullptr;
+      rest = JoinHelper(node_left, node, rest);
+      node = up;
+    }
+    return rest;
+  }
+
+  /**
+   * @brief Splits a detached subtree by key.
+   * @param tree Root of detached subtree, may be nullptr
+   * @param key Key to split by
+   * @param left Output parameter for subtree with keys less than key
+   * @param found Output parameter for detached node with key, or nullptr
+   * @param right Output parameter for subtree with keys greater than key
+   */
+  template <typename K>
+  void SplitHelper(Node *tree, const K &key, Node *&left, Node *&found,
+                   Node *&right) const {
+    left = found = right = nullptr;
+    Node *node = tree;
+    Node *bottom = nullptr;
+    while (node) {
+      bottom = node;
+      if (compare_(key, node->data.first)) {
+        node = node->left;
+      } else if (compare_(node->data.first, key)) {
+        node = node->right;
+      } else {
+        found = node;
+        break;
+      }
+    }
+    // Climb back up the search path: nodes passed on the left go to the
+    // right part with their right subtrees and vice versa
+    Node *child = nullptr;
+    node = bottom;
+    if (found) {
+      node = found->parent;
+      child = found;
+      Detach(found, left, right);
+    }
+    while (node) {
+      Node *up = node->parent;
+      bool went_left =
+          child ? node->left == child : compare_(key, node->data.first);
+      Node *other = went_left ? node->right : node->left;
+      if (other)
+        other->parent = nullptr;
+      if (went_left) {
+        right = JoinHelper(right, node, other);
+      } else {
+        left = JoinHelper(other, node, left);
+      }
+      child = node;
+      node = up;
+    }
+  }
+
+  /**
+   * @brief Helper function for splitting the tree into two.
+   * @param key Smallest key that goes to the returned tree
+   * @return Tree with all elements whose keys are >= key
+   */
+  template <typename K> BinarySearchTree SplitOff(const K &key) {
+    BinarySearchTree result(compare_, allocator_);
+    result.allocator_.Share(allocator_);
+    Node *left = nullptr;
+    Node *found = nullptr;
+    Node *right = nullptr;
+    SplitHelper(root_, key, left, found, right);
+    if (found)
+      right = JoinHelper(nullptr, found, right);
+    size_t left_size = CountLeft(left, right, size_);
+    result.root_ = right;
+    result.size_ = size_ - left_size;
+    root_ = left;
+    size_ = left_size;
+    return result;
+  }
+
+  /**
+   * @brief Counts nodes of the left of two subtrees holding total nodes.
+   *
+   * Without stored sizes both subtrees are walked in lockstep until the
+   * smaller one ends.
+   */
+  static size_t CountLeft(Node *left, Node *right, size_t total) {
+    if constexpr (kOrderStatistics) {
+      return SubtreeSize(left);
+    } else {
+      size_t count = 0;
+      Node *left_node = Leftmost(left);
+      Node *right_node = Leftmost(right);
+      while (left_node && right_node) {
+        left_node = Successor(left_node);
+        right_node = Successor(right_node);
+        ++count;
+      }
+      return left_node ? total - count : count;
+    }
+  }
+
+  /**
+   * @brief Pending step of a set operation: a part of this tree split by
+   * the key of a node of the other tree.
+   */
+  struct SetStep {
+    const Node *other; ///< Node of the other tree whose key split the part
+    Node *left;        ///< Keys less than the key, combined with other->left
+    Node *found;       ///< Detached node with the key, or nullptr
+    Node *right;   ///< Keys greater than the key, combined with other->right
+    bool on_right; ///< true once the left side is done
+  };
+
+  /**
+   * @brief Runs a join-based set operation on a detached subtree.
+   *
+   * The subtree is split by the key of other's root, the left part is
+   * combined with other's left subtree and the right part with the right
+   * one, then combine joins the parts back. Pending steps are kept on a
+   * stack in the heap, so the depth of other is not limited by the call
+   * stack. If combine throws, pending parts are joined back and the
+   * subtree stays valid.
+   *
+   * @tparam Leaf Callable as bool leaf(Node *&part, const Node *other)
+   * @tparam Combine Callable as Node *combine(SetStep &step)
+   * @param tree Root of detached subtree, replaced by root of the result
+   * @param other Subtree of the other tree
+   * @param leaf Settles a part without splitting it, e.g. when other is
+   * empty, and returns true, otherwise returns false
+   * @param combine Joins parts of a step whose both sides are done and
+   * returns the root, may change found
+   */
+  template <typename Leaf, typename Combine>
+  void SetOperationHelper(Node *&tree, const Node *other, Leaf leaf,
+                          Combine combine) {
+    std::vector<SetStep> steps;
+    // Part processed below depth steps: tree, or the current side of the
+    // step at that depth
+    auto slot = [&tree, &steps](size_t depth) -> Node *& {
+      if (depth == 0)
+        return tree;
+      SetStep &step = steps[depth - 1];
+      return step.on_right ? step.right : step.left;
+    };
+    try {
+      while (true) {
+        if (!leaf(slot(steps.size()), other)) {
+          steps.push_back(SetStep{other, nullptr, nullptr, nullptr, false});
+          // The part moves from the side of the parent step into this one
+          Node *part = std::exchange(slot(steps.size() - 1), nullptr);
+          SetStep &step = steps.back();
+          SplitHelper(part, other->data.first, step.left, step.found,
+                      step.right);
+          other = other->left;
+          continue;
+        }
+        // Climb while both sides of the top step are done
+        while (!steps.empty() && steps.back().on_right) {
+          Node *joined = combine(steps.back());
+          steps.pop_back();
+          slot(steps.size()) = joined;
+        }
+        if (steps.empty())
+          return;
+        steps.back().on_right = true;
+        other = steps.back().other->right;
+      }
+    } catch (...) {
+      while (!steps.empty()) {
+        SetStep &step = steps.back();
+        Node *joined = step.found
+                           ? JoinHelper(step.left, step.found, step.right)
+                           : JoinTwo(step.left, step.right);
+        steps.pop_back();
+        slot(steps.size()) = joined;
+      }
+      throw;
+    }
+  }
+
+  /**
+   * @brief Adds copies of other's nodes to a detached subtree.
+   *
+   * The subtree stays valid if an exception is thrown.
+   *
+   * @param tree Root of detached subtree, replaced by root of the union
+   * @param other Subtree of the other tree
+   * @param resolve Resolver of values of equal keys
+   * @param on_added Called with the element of every copied node
+   * @param added Incremented for every copied node
+   */
+  template <typename Resolve, typename OnAdded>
+  void UnionHelper(Node *&tree, const Node *other, Resolve &resolve,
+                   OnAdded &on_added, size_t &added) {
+    SetOperationHelper(
+        tree, other, [](Node *&, const Node *other) { return !other; },
+        [this, &resolve, &on_added, &added](SetStep &step) {
+          if (step.found) {
+            resolve(step.found->data.second, step.other->data.second);
+          } else {
+            step.found =
+                allocator_.Create(step.other->data.first,
+                                  step.other->data.second);
+            ++added;
+            on_added(step.found->data);
+          }
+          return JoinHelper(step.left, step.found, step.right);
+        });
+  }
+
+  /**
+   * @brief Removes nodes with keys absent from other.
+   * @param tree Root of detached subtree, replaced by root of the result
+   * @param other Subtree of the other tree
+   * @param removed Incremented for every destroyed node
+   */
+  void IntersectionHelper(Node *&tree, const Node *other, size_t &removed) {
+    SetOperationHelper(
+        tree, other,
+        [this, &removed](Node *&part, const Node *other) {
+          if (part && !other) {
+            removed += ClearHelper(part);
+            part = nullptr;
+          }
+          return !part || !other;
+        },
+        [](SetStep &step) {
+          return step.found ? JoinHelper(step.left, step.found, step.right)
+                            : JoinTwo(step.left, step.right);
+        });
+  }
+
+  /**
+   * @brief Removes nodes with keys present in other.
+   * @param tree Root of detached subtree, replaced by root of the result
+   * @param other Subtree of the other tree
+   * @param removed Incremented for every destroyed node
+   */
+  void DifferenceHelper(Node *&tree, const Node *other, size_t &removed) {
+    SetOperationHelper(
+        tree, other,
+        [](Node *&part, const Node *other) { return !part || !other; },
+        [this, &removed](SetStep &step) {
+          if (step.found) {
+            allocator_.Destroy(step.found);
+            step.found = nullptr;
+            ++removed;
+          }
+          return JoinTwo(step.left, step.right);
+        });
+  }
+};
 
 #endif // BINARY_SEARCH_TREE_HPP
@@ -0,0 +1,416 @@
+/**
+ * @file node_allocators.hpp
+ * @brief Node allocation policies for BinarySearchTree
+ * @author Dmitry Burbas
+ * @date 03/11/2025
+ */
+
+#ifndef NODE_ALLOCATORS_HPP
+#define NODE_ALLOCATORS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Allocation policy: every node is a separate new/delete.
+ */
+struct HeapNodeAllocation {
+  /**
+   * @brief Stateless allocator of tree nodes.
+   * @tparam Node Node type of the tree
+   */
+  template <typename Node> class Allocator {
+  public:
+    /**
+     * @brief Allocates and constructs a node.
+     * @param args Arguments forwarded to node initialization
+     * @return Pointer to the new node
+     */
+    template <typename... Args> Node *Create(Args &&...args) {
+      return new Node(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Destroys and deallocates a node.
+     * @param node Node created by this allocator
+     */
+    void Destroy(Node *node) { delete node; }
+
+    /**
+     * @brief Destroys and deallocates a node, as Destroy.
+     * @param node Node created by this allocator
+     */
+    void Discard(Node *node) { delete node; }
+
+    /// false: Release frees nothing, every node is freed by Destroy
+    static constexpr bool kReleaseFreesNodes = false;
+
+    /**
+     * @brief Does nothing, heap allocation has no capacity.
+     */
+    void Reserve(size_t) {}
+
+    /**
+     * @brief Does nothing, nodes are already freed by Destroy.
+     */
+    void Release() {}
+
+    /**
+     * @brief Does nothing, the allocator has no state.
+     */
+    void Swap(Allocator &) noexcept {}
+
+    /**
+     * @brief Does nothing, every node owns its memory.
+     */
+    void Share(const Allocator &) {}
+
+    /**
+     * @brief Does nothing, every node owns its memory.
+     */
+    void Absorb(Allocator &) {}
+  };
+};
+
+/**
+ * @brief Allocation policy: nodes are carved from contiguous slabs.
+ *
+ * Slabs grow geometrically, erased nodes are recycled through a free list
+ * and the whole storage is returned at once when the tree is cleared.
+ * Neighbouring nodes allocated together stay close in memory, which
+ * reduces cache misses on traversal.
+ *
+ * Slabs are reference counted, so that trees split from one another can
+ * keep nodes in the same slabs. A slab is freed when the last tree using
+ * it is cleared.
+ *
+ * Slabs come from a std::pmr::memory\_resource, the default resource
+ * unless another one is given. Keys and values that use polymorphic
+ * allocators, such as std::pmr::string, are constructed with the same
+ * resource, so a tree over std::monotonic\_buffer\_resource keeps all
+ * its memory in the buffer and erasing nodes frees nothing per node.
+ */
+struct PoolNodeAllocation {
+  /**
+   * @brief Slab allocator of tree nodes. Owned by a single tree.
+   *
+   * Free list and current slab are never shared, only the memory of
+   * slabs is: an allocator references every slab holding its nodes.
+   *
+   * @tparam Node Node type of the tree
+   */
+  template <typename Node> class Allocator {
+  public:
+    /**
+     * @brief Default constructor. Creates an allocator without slabs.
+     */
+    Allocator() = default;
+
+    /**
+     * @brief Creates an allocator without slabs drawing from a resource.
+     * @param resource Source of slabs and of key and value memory, must
+     * outlive the allocator and the nodes
+     */
+    explicit Allocator(std::pmr::memory_resource *resource)
+        : resource_(resource) {}
+
+    /**
+     * @brief Copying gives a fresh allocator with the same memory resource,
+     * slabs are never shared.
+     */
+    Allocator(const Allocator &other) : resource_(other.resource_) {}
+
+    /**
+     * @brief Copy assignment keeps own slabs, they are never shared.
+     */
+    Allocator &operator=(const Allocator &) { return *this; }
+
+    /**
+     * @brief Destructor. Returns all slabs to the system.
+     *
+     * All nodes must be destroyed before.
+     */
+    ~Allocator() { Release(); }
+
+    /**
+     * @brief Constructs a node in the next free slot.
+     * @param args Arguments forwarded to node initialization
+     * @return Pointer to the new node
+     */
+    template <typename... Args> Node *Create(Args &&...args) {
+      void *slot = TakeSlot();
+      try {
+        return Construct(slot, std::forward<Args>(args)...);
+      } catch (...) {
+        PutSlot(slot);
+        throw;
+      }
+    }
+
+    /**
+     * @brief Destroys a node and puts its slot to the free list.
+     * @param node Node created by this allocator
+     */
+    void Destroy(Node *node) {
+      node->~Node();
+      PutSlot(node);
+    }
+
+    /**
+     * @brief Destroys a node without recycling its slot, for nodes whose
+     * slabs are about to be released.
+     * @param node Node created by this allocator
+     */
+    void Discard(Node *node) { node->~Node(); }
+
+    /// true: Release frees memory of all nodes, only their destructors
+    /// have to run before
+    static constexpr bool kReleaseFreesNodes = true;
+
+    /**
+     * @brief Ensures that next count nodes are placed in one slab.
+     *
+     * Untouched slots of the current slab go to the free list when a new
+     * slab is started, so they are not lost until Release.
+     *
+     * @param count Number of nodes to reserve
+     */
+    void Reserve(size_t count) {
+      if (static_cast<size_t>(slab_end_ - slab_next_) < count) {
+        while (slab_next_ != slab_end_)
+          PutSlot(slab_next_++);
+        AddSlab(count);
+      }
+    }
+
+    /**
+     * @brief Frees all slabs not used by other trees.
+     *
+     * All nodes must be destroyed before.
+     */
+    void Release() {
+      slabs_.clear();
+      free_list_ = nullptr;
+      slab_next_ = nullptr;
+      slab_end_ = nullptr;
+      next_slab_size_ = kMinSlabSize;
+    }
+
+    /**
+     * @brief Exchanges slabs with another allocator.
+     * @param other Allocator to swap with
+     */
+    void Swap(Allocator &other) noexcept {
+      std::swap(resource_, other.resource_);
+      slabs_.swap(other.slabs_);
+      std::swap(free_list_, other.free_list_);
+      std::swap(slab_next_, other.slab_next_);
+      std::swap(slab_end_, other.slab_end_);
+      std::swap(next_slab_size_, other.next_slab_size_);
+    }
+
+    /**
+     * @brief Starts referencing slabs of another allocator.
+     *
+     * Called when nodes of other's tree are handed over without being
+     * moved, e.g. when a tree is split in two.
+     *
+     * @param other Allocator whose slabs hold nodes of this one's tree
+     */
+    void Share(const Allocator &other) {
+      slabs_.insert(slabs_.end(), other.slabs_.begin(), other.slabs_.end());
+      std::sort(slabs_.begin(), slabs_.end());
+      slabs_.erase(std::unique(slabs_.begin(), slabs_.end()), slabs_.end());
+    }
+
+    /**
+     * @brief Takes over slabs and free slots of another allocator.
+     *
+     * Called when all nodes of other's tree are handed over to this one.
+     * The other allocator is left empty.
+     *
+     * @param other Allocator to take storage from
+     */
+    void Absorb(Allocator &other) {
+      Share(other);
+      if (other.free_list_) {
+        Slot *tail = other.free_list_;
+        while (tail->next_free)
+          tail = tail->next_free;
+        tail->next_free = free_list_;
+        free_list_ = other.free_list_;
+        other.free_list_ = nullptr;
+      }
+      other.Release();
+    }
+
+    /**
+     * @brief Returns the resource slabs, keys and values are taken from.
+     */
+    std::pmr::memory_resource *GetResource() const { return resource_; }
+
+  private:
+    /**
+     * @brief Raw storage of one node, doubles as a free list link.
+     */
+    union Slot {
+      Slot *next_free; ///< Link in the free list
+      alignas(Node) unsigned char storage[sizeof(Node)]; ///< Node bytes
+    };
+
+    /// Allocator passed to keys and values that use polymorphic allocators
+    using Resourced = std::pmr::polymorphic_allocator<std::byte>;
+
+    static constexpr size_t kMinSlabSize = 32;    ///< Nodes in first slab
+    static constexpr size_t kMaxSlabSize = 65536; ///< Growth limit of slabs
+
+    /// Source of slabs and of memory of keys and values
+    std::pmr::memory_resource *resource_ = std::pmr::get_default_resource();
+    std::vector<std::shared_ptr<Slot>> slabs_; ///< Referenced slabs
+    Slot *free_list_ = nullptr;            ///< Recycled slots
+    Slot *slab_next_ = nullptr;            ///< Next untouched slot of slab
+    Slot *slab_end_ = nullptr;             ///< End of current slab
+    size_t next_slab_size_ = kMinSlabSize; ///< Size of next slab
+
+    /**
+     * @brief Allocates new slab and makes it current.
+     * @param count Number of slots in the slab
+     */
+    void AddSlab(size_t count) {
+      std::pmr::memory_resource *resource = resource_;
+      Slot *slab = static_cast<Slot *>(
+          resource->allocate(count * sizeof(Slot), alignof(Slot)));
+      // If the control block or the vector fails to allocate, the deleter
+      // still frees the slab. It keeps the resource, so slabs handed over
+      // to a tree with another resource are returned where they came from
+      slabs_.push_back(
+          std::shared_ptr<Slot>(slab, [resource, count](Slot *memory) {
+            resource->deallocate(memory, count * sizeof(Slot), alignof(Slot));
+          }));
+      slab_next_ = slab;
+      slab_end_ = slab + count;
+    }
+
+    /**
+     * @brief Returns free slot, recycled ones first.
+     */
+    void *TakeSlot() {
+      if (free_list_) {
+        Slot *slot = free_list_;
+        free_list_ = slot->next_free;
+        return slot;
+      }
+      if (slab_next_ == slab_end_) {
+        AddSlab(next_slab_size_);
+        if (next_slab_size_ < kMaxSlabSize)
+          next_slab_size_ *= 2;
+      }
+      return slab_next_++;
+    }
+
+    /**
+     * @brief Constructs a node in a slot.
+     *
+     * If the key or the value uses polymorphic allocators, the pair is
+     * built piecewise in the node and the resource of this allocator is
+     * passed to the key and the value by uses-allocator construction.
+     *
+     * @param slot Memory for the node
+     * @param args Arguments of the key-value pair constructor
+     * @return Pointer to the new node
+     */
+    template <typename... Args> Node *Construct(void *slot, Args &&...args) {
+      using Pair = decltype(std::declval<Node &>().data);
+      using Key = std::remove_const_t<typename Pair::first_type>;
+      using Value = typename Pair::second_type;
+      if constexpr (std::uses_allocator_v<Key, Resourced> ||
+                    std::uses_allocator_v<Value, Resourced>) {
+        auto [key_args, value_args] =
+            PiecewiseArgs(std::forward<Args>(args)...);
+        return new (slot)
+            Node(std::piecewise_construct,
+                 UsesAllocatorArgs<Key>(std::move(key_args)),
+                 UsesAllocatorArgs<Value>(std::move(value_args)));
+      } else {
+        return new (slot) Node(std::forward<Args>(args)...);
+      }
+    }
+
+    /**
+     * @brief Splits arguments of a pair constructor into arguments of the
+     * key and of the value: none, key and value, a pair or piecewise
+     * tuples.
+     * @return Pair of tuples of references to the arguments
+     */
+    static std::pair<std::tuple<>, std::tuple<>> PiecewiseArgs() {
+      return {};
+    }
+    template <typename K, typename V>
+    static auto PiecewiseArgs(K &&key, V &&value) {
+      return std::make_pair(std::forward_as_tuple(std::forward<K>(key)),
+                            std::forward_as_tuple(std::forward<V>(value)));
+    }
+    template <typename Other> static auto PiecewiseArgs(Other &&pair) {
+      return std::make_pair(
+          std::forward_as_tuple(std::get<0>(std::forward<Other>(pair))),
+          std::forward_as_tuple(std::get<1>(std::forward<Other>(pair))));
+    }
+    template <typename KeyArgs, typename ValueArgs>
+    static auto PiecewiseArgs(std::piecewise_construct_t, KeyArgs &&key_args,
+                              ValueArgs &&value_args) {
+      return std::make_pair(std::forward<KeyArgs>(key_args),
+                            std::forward<ValueArgs>(value_args));
+    }
+
+    /**
+     * @brief Adds the resource of this allocator to constructor arguments
+     * of a type that uses polymorphic allocators, as a leading
+     * std::allocator\_arg pair or as the last argument.
+     * @tparam T Type to construct
+     * @param args Tuple of references to the arguments
+     * @return Arguments to construct T from
+     */
+    template <typename T, typename Tuple>
+    auto UsesAllocatorArgs(Tuple &&args) const {
+      if constexpr (!std::uses_allocator_v<T, Resourced>) {
+        return std::forward<Tuple>(args);
+      } else {
+        Resourced allocator(resource_);
+        return std::apply(
+            [&allocator](auto &&...arguments) {
+              if constexpr (std::is_constructible_v<
+                                T, std::allocator_arg_t, const Resourced &,
+                                decltype(arguments)...>) {
+                return std::tuple<std::allocator_arg_t, Resourced,
+                                  decltype(arguments)...>(
+                    std::allocator_arg, allocator,
+                    std::forward<decltype(arguments)>(arguments)...);
+              } else {
+                return std::tuple<decltype(arguments)..., Resourced>(
+                    std::forward<decltype(arguments)>(arguments)...,
+                    allocator);
+              }
+            },
+            std::forward<Tuple>(args));
+      }
+    }
+
+    /**
+     * @brief Puts slot to the free list.
+     */
+    void PutSlot(void *memory) {
+      Slot *slot = new (memory) Slot;
+      slot->next_free = free_list_;
+      free_list_ = slot;
+    }
+  };
+};
+
+#endif // NODE_ALLOCATORS_HPP
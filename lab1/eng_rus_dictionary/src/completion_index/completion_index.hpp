@@ -0,0 +1,285 @@
+/**
+ * @file completion_index.hpp
+ * @brief Weighted index of sorted elements for top-k range queries
+ * @author Dmitry Burbas
+ * @date 24/11/2025
+ */
+
+#ifndef COMPLETION_INDEX_HPP
+#define COMPLETION_INDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Weights of elements owned by a sorted container, indexed by
+ * position, answering "k heaviest elements in positions [first, last)".
+ *
+ * The index doesn't own elements, it keeps pointers to elements of a
+ * container whose elements never move, e.g. BinarySearchTree, in their
+ * sorted order. A bottom-up segment tree stores for every node the
+ * position of the heaviest element below it. A query pops the heaviest
+ * element of a part of the range from a heap and splits the part around
+ * it, so k elements take O(k log n) whatever the length of the range.
+ *
+ * Heavier elements come first, of equal weights the one with the smaller
+ * position. Changing a weight takes O(log n); inserting or erasing an
+ * element shifts positions, so the index has to be assigned anew. Memory
+ * comes from a std::pmr::memory\_resource.
+ *
+ * @tparam Element Type of indexed elements
+ */
+template <typename Element> class CompletionIndex {
+public:
+  /**
+   * @brief Creates an empty index.
+   * @param resource Source of the index memory, must outlive the index
+   */
+  explicit CompletionIndex(
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : resource_(resource) {}
+
+  /**
+   * @brief Copying is forbidden, elements of the copy live elsewhere.
+   */
+  CompletionIndex(const CompletionIndex &) = delete;
+  CompletionIndex &operator=(const CompletionIndex &) = delete;
+
+  /**
+   * @brief Move constructor. Takes the arrays of another index in O(1).
+   * @param other Index to move from, left empty
+   */
+  CompletionIndex(CompletionIndex &&other) noexcept
+      : resource_(other.resource_) {
+    Swap(other);
+  }
+
+  /**
+   * @brief Move assignment operator. Takes the arrays and the resource.
+   * @param other Index to move from, left empty
+   * @return Reference to this index
+   */
+  CompletionIndex &operator=(CompletionIndex &&other) noexcept {
+    if (this != &other) {
+      Release();
+      Swap(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Destructor. Returns the arrays to the memory resource.
+   */
+  ~CompletionIndex() { Release(); }
+
+  /**
+   * @brief Exchanges arrays and memory resources of two indexes in O(1).
+   * @param other Index to swap with
+   */
+  void Swap(CompletionIndex &other) noexcept {
+    std::swap(resource_, other.resource_);
+    std::swap(weights_, other.weights_);
+    std::swap(elements_, other.elements_);
+    std::swap(best_, other.best_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+  }
+
+  /**
+   * @brief Indexes elements of a sorted range in O(n).
+   * @tparam ForwardIt Iterator to elements that stay in place
+   * @tparam WeightOf Callable as uint64\_t weight\_of(const Element &)
+   * @param first Beginning of the range
+   * @param last End of the range
+   * @param weight_of Weight of an element, called once per element in
+   * order of the range
+   * @throw std::length\_error if the range has 2^32 elements or more
+   */
+  template <typename ForwardIt, typename WeightOf>
+  void Assign(ForwardIt first, ForwardIt last, WeightOf weight_of) {
+    Clear();
+    size_t size = static_cast<size_t>(std::distance(first, last));
+    if (size > std::numeric_limits<Position>::max())
+      throw std::length_error("Too many elements for CompletionIndex");
+    if (size > capacity_) {
+      Release();
+      Allocate(size);
+    }
+    for (size_t position = 0; first != last; ++first, ++position) {
+      elements_[position] = &*first;
+      weights_[position] = weight_of(*first);
+    }
+    // If weight_of throws, the index stays empty
+    size_ = size;
+    // Leaves are nodes size..2 * size - 1, node i covers nodes 2i, 2i + 1
+    for (size_t position = 0; position < size; ++position)
+      best_[size + position] = static_cast<Position>(position);
+    for (size_t node = size; node-- > 1;)
+      best_[node] = Better(best_[2 * node], best_[2 * node + 1]);
+  }
+
+  /**
+   * @brief Removes all elements, keeping allocated memory.
+   */
+  void Clear() { size_ = 0; }
+
+  /**
+   * @brief Returns the number of indexed elements.
+   */
+  size_t GetSize() const { return size_; }
+
+  /**
+   * @brief Returns the weight of the element at a position.
+   * @param position Position less than GetSize()
+   */
+  uint64_t GetWeight(size_t position) const { return weights_[position]; }
+
+  /**
+   * @brief Changes the weight of the element at a position in O(log n).
+   * @param position Position less than GetSize()
+   * @param weight New weight
+   */
+  void SetWeight(size_t position, uint64_t weight) {
+    weights_[position] = weight;
+    for (size_t node = (GetSize() + position) / 2; node > 0; node /= 2)
+      best_[node] = Better(best_[2 * node], best_[2 * node + 1]);
+  }
+
+  /**
+   * @brief Visits the heaviest elements of a range of positions.
+   * @tparam Func Callable as func(const Element &)
+   * @param first First position of the range
+   * @param last Position after the range, at most GetSize()
+   * @param count Maximum number of elements to visit
+   * @param func Function called for each element, heaviest first
+   */
+  template <typename Func>
+  void TopK(size_t first, size_t last, size_t count, Func func) const {
+    if (first >= last || count == 0)
+      return;
+    // Parts of the range with their heaviest elements, heaviest on top
+    struct Part {
+      size_t best;  ///< Position of the heaviest element of the part
+      size_t first; ///< First position of the part
+      size_t last;  ///< Position after the part
+    };
+    auto lighter = [this](const Part &part, const Part &other) {
+      return Precedes(other.best, part.best);
+    };
+    std::vector<Part> parts;
+    parts.reserve(std::min(count, last - first) + 1);
+    parts.push_back(Part{BestIn(first, last), first, last});
+    while (count-- > 0 && !parts.empty()) {
+      std::pop_heap(parts.begin(), parts.end(), lighter);
+      Part part = parts.back();
+      parts.pop_back();
+      func(*elements_[part.best]);
+      if (part.first < part.best) {
+        parts.push_back(
+            Part{BestIn(part.first, part.best), part.first, part.best});
+        std::push_heap(parts.begin(), parts.end(), lighter);
+      }
+      if (part.best + 1 < part.last) {
+        parts.push_back(
+            Part{BestIn(part.best + 1, part.last), part.best + 1, part.last});
+        std::push_heap(parts.begin(), parts.end(), lighter);
+      }
+    }
+  }
+
+private:
+  /// Position stored in the segment tree, half the size of size\_t
+  using Position = uint32_t;
+
+  std::pmr::memory_resource *resource_; ///< Source of the arrays
+  uint64_t *weights_ = nullptr;         ///< Weights of elements
+  const Element **elements_ = nullptr;  ///< Elements in sorted order
+  /// Segment tree of positions of the heaviest elements, node 0 unused
+  Position *best_ = nullptr;
+  size_t size_ = 0;     ///< Number of indexed elements
+  size_t capacity_ = 0; ///< Number of elements the arrays have room for
+
+  /**
+   * @brief Returns the size of one block holding all arrays.
+   * @param capacity Number of elements
+   */
+  static size_t BlockSize(size_t capacity) {
+    return capacity * (sizeof(uint64_t) + sizeof(const Element *) +
+                       2 * sizeof(Position));
+  }
+
+  /**
+   * @brief Takes arrays for capacity elements from the resource as one
+   * block: weights, then elements, then the segment tree.
+   * @param capacity Number of elements, the index must have no arrays
+   */
+  void Allocate(size_t capacity) {
+    static_assert(alignof(const Element *) <= alignof(uint64_t) &&
+                      alignof(Position) <= alignof(const Element *),
+                  "arrays must be laid out by decreasing alignment");
+    void *block = resource_->allocate(BlockSize(capacity), alignof(uint64_t));
+    weights_ = static_cast<uint64_t *>(block);
+    elements_ = reinterpret_cast<const Element **>(weights_ + capacity);
+    best_ = reinterpret_cast<Position *>(elements_ + capacity);
+    capacity_ = capacity;
+  }
+
+  /**
+   * @brief Returns the arrays to the memory resource.
+   */
+  void Release() {
+    if (weights_) {
+      resource_->deallocate(weights_, BlockSize(capacity_),
+                            alignof(uint64_t));
+    }
+    weights_ = nullptr;
+    elements_ = nullptr;
+    best_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+  }
+
+  /**
+   * @brief Checks if an element comes before another one in results.
+   */
+  bool Precedes(size_t position, size_t other) const {
+    if (weights_[position] != weights_[other])
+      return weights_[position] > weights_[other];
+    return position < other;
+  }
+
+  /**
+   * @brief Returns the one of two positions that comes first in results.
+   */
+  Position Better(Position position, Position other) const {
+    return Precedes(position, other) ? position : other;
+  }
+
+  /**
+   * @brief Finds the heaviest element in positions [first, last) in
+   * O(log n).
+   * @param first First position, less than last
+   * @param last Position after the range
+   * @return Position of the heaviest element
+   */
+  size_t BestIn(size_t first, size_t last) const {
+    Position best = static_cast<Position>(first);
+    for (size_t low = first + GetSize(), high = last + GetSize(); low < high;
+         low /= 2, high /= 2) {
+      if (low & 1)
+        best = Better(best, best_[low++]);
+      if (high & 1)
+        best = Better(best, best_[--high]);
+    }
+    return best;
+  }
+};
+
+#endif // COMPLETION_INDEX_HPP
@@ -0,0 +1,157 @@
+/**
+ * @file concurrent_dictionary.cc
+ * @brief Implementation of ConcurrentDictionary class methods
+ * @author Dmitry Burbas
+ * @date 15/11/2025
+ */
+
+#include "../dictionary_utils/dictionary_utils.h"
+#include "concurrent_dictionary.h"
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * @brief Read-side critical section.
+ *
+ * While the guard is alive the version it loaded is not freed. Entering
+ * and leaving cost one atomic increment and decrement of a counter that
+ * is shared only with threads hashed to the same shard.
+ */
+class ConcurrentDictionary::ReadGuard {
+public:
+  explicit ReadGuard(const ConcurrentDictionary &dict) {
+    size_t generation = dict.generation_.load() & 1;
+    counter_ = &dict.shards_[ShardIndex()].readers[generation];
+    // The increment must be ordered before loading current_, so that a
+    // writer which replaced the version we load sees us in the counter
+    counter_->fetch_add(1);
+    version_ = dict.current_.load();
+  }
+  ~ReadGuard() { counter_->fetch_sub(1, std::memory_order_release); }
+
+  ReadGuard(const ReadGuard &) = delete;
+  ReadGuard &operator=(const ReadGuard &) = delete;
+
+  const Version *operator->() const { return version_; }
+  const Version &operator*() const { return *version_; }
+
+private:
+  std::atomic<size_t> *counter_; ///< Counter this reader is announced in
+  const Version *version_;       ///< Version being read
+};
+
+ConcurrentDictionary::ConcurrentDictionary() : current_(new Version()) {}
+ConcurrentDictionary::~ConcurrentDictionary() { delete current_.load(); }
+
+ConcurrentDictionary &ConcurrentDictionary::operator+=(
+    const std::pair<std::string, std::string> &word_pair) {
+  if (!utils::IsEnglishWord(word_pair.first)) {
+    throw std::invalid_argument(
+        "Invalid argument format: first word must be english");
+  }
+  if (!utils::IsRussianWord(word_pair.second)) {
+    throw std::invalid_argument(
+        "Invalid argument format: second word must be russian");
+  }
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  auto next = std::make_unique<Version>(
+      *current_.load(std::memory_order_relaxed));
+  next->Insert(word_pair.first, word_pair.second);
+  Publish(next.release());
+  return *this;
+}
+ConcurrentDictionary &
+ConcurrentDictionary::operator+=(const std::string &word_pair) {
+  std::pair<std::string, std::string> words;
+  utils::ParseWordPair(words.first, words.second, word_pair);
+  return *this += words;
+}
+ConcurrentDictionary &ConcurrentDictionary::operator+=(const char *word_pair) {
+  return *this += std::string(word_pair);
+}
+
+ConcurrentDictionary &
+ConcurrentDictionary::operator-=(std::string_view english_word) {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: word must be english");
+  }
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  const Version *current = current_.load(std::memory_order_relaxed);
+  if (!current->Contains(english_word)) {
+    throw std::out_of_range("Word not found: " + std::string(english_word));
+  }
+  auto next = std::make_unique<Version>(*current);
+  next->Erase(english_word);
+  Publish(next.release());
+  return *this;
+}
+
+std::string
+ConcurrentDictionary::operator[](std::string_view english_word) const {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: word must be english");
+  }
+  std::optional<std::string> translation = Find(english_word);
+  if (!translation) {
+    throw std::out_of_range("Word not found: " + std::string(english_word));
+  }
+  return std::move(*translation);
+}
+
+std::optional<std::string>
+ConcurrentDictionary::Find(std::string_view english_word) const {
+  ReadGuard version(*this);
+  const std::string *translation = version->Find(english_word);
+  if (!translation)
+    return std::nullopt;
+  return *translation;
+}
+bool ConcurrentDictionary::Contains(std::string_view english_word) const {
+  ReadGuard version(*this);
+  return version->Contains(english_word);
+}
+size_t ConcurrentDictionary::GetSize() const {
+  ReadGuard version(*this);
+  return version->GetSize();
+}
+ConcurrentDictionary::Version ConcurrentDictionary::Snapshot() const {
+  ReadGuard version(*this);
+  return *version;
+}
+
+std::ostream &operator<<(std::ostream &out_stream,
+                         const ConcurrentDictionary &dict) {
+  dict.Snapshot().InOrderTraversal(
+      [&out_stream](const std::string &english_word,
+                    const std::string &russian_word) {
+        out_stream << english_word << ":" << russian_word << "\n";
+      });
+  return out_stream;
+}
+
+void ConcurrentDictionary::Publish(const Version *next) {
+  const Version *previous = current_.exchange(next);
+  Synchronize();
+  delete previous;
+}
+void ConcurrentDictionary::Synchronize() {
+  // Readers of both generations may hold the previous version: flip the
+  // generation so new readers stop joining the drained counters, then wait
+  // for each generation in turn
+  for (int phase = 0; phase < 2; ++phase) {
+    size_t drained = generation_.fetch_add(1) & 1;
+    for (ReaderShard &shard : shards_) {
+      while (shard.readers[drained].load() != 0)
+        std::this_thread::yield();
+    }
+  }
+}
+size_t ConcurrentDictionary::ShardIndex() {
+  thread_local size_t index =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) % kReaderShards;
+  return index;
+}
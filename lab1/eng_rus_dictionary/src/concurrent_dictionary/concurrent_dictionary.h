@@ -0,0 +1,186 @@
+/**
+ * @file concurrent_dictionary.h
+ * @brief Thread-safe English-Russian dictionary for read-mostly workloads
+ * @author Dmitry Burbas
+ * @date 15/11/2025
+ */
+#ifndef CONCURRENT_DICTIONARY_H
+#define CONCURRENT_DICTIONARY_H
+
+#include "../persistent_tree/persistent_tree.hpp"
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * @brief English-Russian dictionary safe for concurrent use.
+ *
+ * Words are kept in a PersistentTree. Writers serialize on a mutex, apply
+ * the change to an O(1) copy of the current version (which copies only
+ * O(log n) nodes) and publish the new version with a single atomic store.
+ * Readers never block: they announce themselves in a sharded reader
+ * counter and read whatever version is current. A writer frees the old
+ * version only after every reader that could have seen it has left, using
+ * two counter generations as in userspace RCU.
+ *
+ * Lookups return copies, since a reference into a version could outlive
+ * it. For long reads (printing, iterating) take a Snapshot().
+ *
+ * @code
+ * ConcurrentDictionary dict;
+ * dict += "hello:привет";
+ * // from any thread:
+ * std::cout << dict["hello"]; // Outputs: привет
+ * @endcode
+ */
+class ConcurrentDictionary {
+public:
+  /// Immutable version of the dictionary
+  using Version = PersistentTree<std::string, std::string>;
+
+  /**
+   * @brief Default constructor. Creates an empty dictionary.
+   */
+  ConcurrentDictionary();
+
+  /**
+   * @brief Destructor. Must not run concurrently with other calls.
+   */
+  ~ConcurrentDictionary();
+
+  ConcurrentDictionary(const ConcurrentDictionary &) = delete;
+  ConcurrentDictionary &operator=(const ConcurrentDictionary &) = delete;
+
+  /**
+   * @brief Adds or replaces a word pair.
+   * @param word_pair Pair of English word and Russian translation
+   * @return Reference to this dictionary
+   * @throw std::invalid\_argument if words are not valid English/Russian
+   */
+  ConcurrentDictionary &
+  operator+=(const std::pair<std::string, std::string> &word_pair);
+
+  /**
+   * @brief Adds or replaces a word pair in format "english:russian".
+   * @param word_pair String with colon-separated words
+   * @return Reference to this dictionary
+   * @throw std::invalid\_argument if format is wrong or words are not valid
+   */
+  ConcurrentDictionary &operator+=(const std::string &word_pair);
+
+  /**
+   * @brief Adds or replaces a word pair from C-string.
+   * @param word_pair C-string with colon-separated words
+   * @return Reference to this dictionary
+   * @throw std::invalid\_argument if format is wrong or words are not valid
+   */
+  ConcurrentDictionary &operator+=(const char *word_pair);
+
+  /**
+   * @brief Removes an English word with its translation.
+   * @param english_word Word to remove
+   * @return Reference to this dictionary
+   * @throw std::invalid\_argument if word is not valid English
+   * @throw std::out\_of\_range if word not found
+   */
+  ConcurrentDictionary &operator-=(std::string_view english_word);
+
+  /**
+   * @brief Returns translation of an English word.
+   * @param english_word English word to look up
+   * @return Copy of Russian translation
+   * @throw std::invalid\_argument if word is not valid English
+   * @throw std::out\_of\_range if word not found
+   */
+  std::string operator[](std::string_view english_word) const;
+
+  /**
+   * @brief Looks up translation of a word.
+   * @param english_word Word to look up
+   * @return Copy of Russian translation, empty if word is not present
+   */
+  std::optional<std::string> Find(std::string_view english_word) const;
+
+  /**
+   * @brief Checks if the dictionary contains a word.
+   * @param english_word Word to look up
+   * @return true if word is present
+   */
+  bool Contains(std::string_view english_word) const;
+
+  /**
+   * @brief Returns the number of word pairs in the dictionary.
+   * @return Size of dictionary
+   */
+  size_t GetSize() const;
+
+  /**
+   * @brief Checks if dictionary is empty.
+   * @return true if dictionary contains no entries
+   */
+  bool IsEmpty() const { return GetSize() == 0; }
+
+  /**
+   * @brief Takes O(1) snapshot of the current version.
+   *
+   * The snapshot is not affected by later changes and may be read
+   * without any synchronization.
+   *
+   * @return Current version of the dictionary
+   */
+  Version Snapshot() const;
+
+  /**
+   * @brief Output stream operator. Prints snapshot of all word pairs in
+   * format "english:russian" in alphabetical order.
+   * @param out_stream Output stream
+   * @param dict Dictionary to output
+   * @return Reference to output stream
+   */
+  friend std::ostream &operator<<(std::ostream &out_stream,
+                                  const ConcurrentDictionary &dict);
+
+private:
+  class ReadGuard;
+
+  /**
+   * @brief Reader counters of one shard, one per generation.
+   */
+  struct alignas(64) ReaderShard {
+    std::atomic<size_t> readers[2] = {}; ///< Active readers per generation
+  };
+
+  static constexpr size_t kReaderShards = 64; ///< Number of counter shards
+
+  std::atomic<const Version *> current_;       ///< Version seen by readers
+  std::atomic<size_t> generation_{0};          ///< Generation of new readers
+  mutable ReaderShard shards_[kReaderShards]; ///< Sharded reader counters
+  std::mutex writer_mutex_;                    ///< Serializes writers
+
+  /**
+   * @brief Publishes new version and frees the old one once unused.
+   *
+   * Must be called with writer\_mutex\_ held.
+   *
+   * @param next Version to publish, ownership is taken
+   */
+  void Publish(const Version *next);
+
+  /**
+   * @brief Waits until every reader that started before the call is done.
+   */
+  void Synchronize();
+
+  /**
+   * @brief Shard of reader counters used by the calling thread.
+   * @return Index in shards\_
+   */
+  static size_t ShardIndex();
+};
+
+#endif // CONCURRENT_DICTIONARY_H
@@ -6,44 +6,51 @@
  */
 
 #include "../dictionary_utils/dictionary_utils.h"
+#include "../mapped_file/mapped_file.h"
 #include "dictionary.h"
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <future>
+#include <iterator>
+#include <optional>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
 
+Dictionary::Dictionary(std::pmr::memory_resource *resource)
+    : container_(resource), index_(resource), weights_(resource),
+      completion_(resource) {}
 Dictionary::Dictionary(const Dictionary &other)
-    : container_(other.container_) {}
+    : container_(other.container_), index_(other.GetMemoryResource()),
+      hash_index_(other.hash_index_), weights_(other.weights_),
+      completion_(other.GetMemoryResource()) {
+  RebuildHashIndex();
+}
 Dictionary &Dictionary::operator=(const Dictionary &other) {
   if (this == &other)
     return *this;
   container_ = other.container_;
+  weights_ = other.weights_;
+  completion_stale_ = true;
+  RebuildHashIndex();
   return *this;
 }
 
 Dictionary &
 Dictionary::operator+=(const std::pair<std::string, std::string> &word_pair) {
-  if (!utils::IsEnglishWord(word_pair.first)) {
-    throw std::invalid_argument(
-        "Invalid argument format: first word must be english");
-  }
-  if (!utils::IsRussianWord(word_pair.second)) {
-    throw std::invalid_argument(
-        "Invalid argument format: second word must be russian");
-  }
-  container_.Insert(word_pair.first, word_pair.second);
+  AddWordPair(word_pair.first, word_pair.second);
+  return *this;
+}
+Dictionary &
+Dictionary::operator+=(std::pair<std::string, std::string> &&word_pair) {
+  AddWordPair(word_pair.first, word_pair.second);
   return *this;
 }
 Dictionary &Dictionary::operator+=(const std::string &word_pair) {
   std::string english_word, russian_word;
   utils::ParseWordPair(english_word, russian_word, word_pair);
-  if (!utils::IsEnglishWord(english_word)) {
-    throw std::invalid_argument(
-        "Invalid argument format: first word must be english");
-  }
-  if (!utils::IsRussianWord(russian_word)) {
-    throw std::invalid_argument(
-        "Invalid argument format: second word must be russian");
-  }
-  container_.Insert(english_word, russian_word);
+  AddWordPair(english_word, russian_word);
   return *this;
 }
 Dictionary &Dictionary::operator+=(const char *word_pair) {
@@ -51,38 +58,81 @@ Dictionary &Dictionary::operator+=(const char *word_pair) {
 }
 
 Dictionary &Dictionary::operator-=(const std::string &english_word) {
+  return *this -= std::string_view(english_word);
+}
+Dictionary &Dictionary::operator-=(const char *english_word) {
+  return *this -= std::string_view(english_word);
+}
+Dictionary &Dictionary::operator-=(std::string_view english_word) {
   if (!utils::IsEnglishWord(english_word)) {
     throw std::invalid_argument(
         "Invalid argument format: word must be english");
   }
+  // The index compares keys of stored pairs, so it goes first
+  index_.Erase(english_word);
   if (!container_.Erase(english_word)) {
-    throw std::out_of_range("Word not found: " + english_word);
+    throw std::out_of_range("Word not found: " + std::string(english_word));
   }
+  weights_.Erase(english_word);
+  completion_stale_ = true;
   return *this;
 }
-Dictionary &Dictionary::operator-=(const char *english_word) {
-  return *this -= std::string(english_word);
-}
 
-const std::string &
-Dictionary::operator[](const std::string &english_word) const {
+const Dictionary::String &
+Dictionary::operator[](std::string_view english_word) const {
   if (!utils::IsEnglishWord(english_word)) {
     throw std::invalid_argument(
         "Invalid argument format: word must be english");
   }
-  return container_[english_word];
+  const String *translation = Find(english_word);
+  if (!translation) {
+    throw std::out_of_range("Word not found: " + std::string(english_word));
+  }
+  return *translation;
 }
-std::string &Dictionary::operator[](const std::string &english_word) {
+Dictionary::String &
+Dictionary::operator[](std::string_view english_word) {
   if (!utils::IsEnglishWord(english_word)) {
     throw std::invalid_argument(
         "Invalid argument format: word must be english");
   }
-  return container_[english_word];
+  // Present words are found by view, only a new entry copies the word
+  if (hash_index_) {
+    if (WordPair *word_pair = index_.Find(english_word))
+      return word_pair->second;
+    index_.Reserve(index_.GetSize() + 1);
+  } else {
+    Container::iterator found = container_.lower_bound(english_word);
+    if (found != container_.end() && found->first == english_word)
+      return found->second;
+  }
+  Container::iterator added =
+      container_.TryEmplace(MakeString(english_word)).first;
+  completion_stale_ = true;
+  if (hash_index_)
+    index_.Insert(&*added);
+  return added->second;
+}
+std::vector<const Dictionary::String *>
+Dictionary::LookupBatch(const std::string_view *english_words,
+                        size_t count) const {
+  std::vector<const String *> translations(count);
+  if (!hash_index_) {
+    container_.FindBatch(english_words, count, translations.data());
+    return translations;
+  }
+  std::vector<WordPair *> word_pairs(count);
+  index_.FindBatch(english_words, count, word_pairs.data());
+  for (size_t index = 0; index < count; ++index) {
+    if (word_pairs[index])
+      translations[index] = &word_pairs[index]->second;
+  }
+  return translations;
 }
 std::ostream &operator<<(std::ostream &out_stream, const Dictionary &dict) {
   dict.container_.InOrderTraversal(
-      [&out_stream](const std::string &english_word,
-                    const std::string &russian_word) {
+      [&out_stream](const Dictionary::String &english_word,
+                    const Dictionary::String &russian_word) {
         out_stream << english_word << ":" << russian_word << "\n";
       });
   return out_stream;
@@ -91,25 +141,455 @@ std::ostream &operator<<(std::ostream &out_stream, const Dictionary &dict) {
 std::istream &operator>>(std::istream &in_stream, Dictionary &dict) {
   std::string line;
   while (std::getline(in_stream, line)) {
-    if (line.empty())
-      continue;
+    // Invalid lines are skipped without throwing exceptions
+    std::string_view english_word, russian_word;
+    if (utils::SplitWordPair(line, english_word, russian_word))
+      dict.AddWordPair(english_word, russian_word);
+  }
+  return in_stream;
+}
+bool Dictionary::LoadFromFile(const std::string &filename,
+                              size_t thread_count) {
+  std::optional<MappedFile> file;
+  try {
+    file.emplace(filename);
+  } catch (const std::system_error &exception) {
+    return false;
+  }
+  if (thread_count == 0)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::pair<String, String>> word_pairs =
+      ReadWordPairs(file->GetContents(), GetMemoryResource(), thread_count);
+  container_.AssignSorted(std::make_move_iterator(word_pairs.begin()),
+                          std::make_move_iterator(word_pairs.end()));
+  completion_stale_ = true;
+  DropAbsentWeights();
+  RebuildHashIndex();
+  return true;
+}
+
+namespace {
 
-    try {
-      dict += line;
-    } catch (const std::exception &exception) {
-      continue;
+/// Smallest part of a file worth a thread of its own
+constexpr size_t kMinChunkSize = 1 << 16;
+
+/**
+ * @brief Exclusive upper bound of prefix search, utils::NextPrefix kept on
+ * the stack.
+ *
+ * Prefixes longer than any practical word fall back to the heap.
+ */
+class PrefixEnd {
+public:
+  explicit PrefixEnd(std::string_view prefix) {
+    char *buffer = inline_.data();
+    if (prefix.size() > inline_.size()) {
+      heap_.resize(prefix.size());
+      buffer = heap_.data();
     }
+    end_ = utils::NextPrefix(prefix, buffer);
   }
-  return in_stream;
+  PrefixEnd(const PrefixEnd &) = delete;
+  PrefixEnd &operator=(const PrefixEnd &) = delete;
+
+  /// Upper bound, empty if every word after the prefix matches
+  std::string_view Get() const { return end_; }
+
+private:
+  std::array<char, 64> inline_; ///< Storage of bounds of short prefixes
+  std::string heap_;            ///< Storage of bounds of long prefixes
+  std::string_view end_;        ///< The bound in one of the storages
+};
+
+/**
+ * @brief View of a word pair with the packed prefix of its English word.
+ */
+struct KeyedView {
+  uint64_t prefix;          ///< utils::PackPrefix of english
+  std::string_view english; ///< English word in the text
+  std::string_view russian; ///< Russian word in the text
+};
+
+/**
+ * @brief Orders views by English word, equal words by position in the
+ * text.
+ *
+ * Most comparisons are decided by prefixes without reading the text. All
+ * views point into one text, so positions order equal words of different
+ * chunks as well.
+ */
+bool KeyedLess(const KeyedView &first, const KeyedView &second) {
+  if (first.prefix != second.prefix)
+    return first.prefix < second.prefix;
+  if (first.english != second.english)
+    return first.english < second.english;
+  return first.english.data() < second.english.data();
+}
+
+/**
+ * @brief Splits a text into at most count parts ending at ends of lines.
+ * @param text Text to split
+ * @param count Desired number of parts
+ * @return Parts covering the whole text, at least one
+ */
+std::vector<std::string_view> SplitIntoChunks(std::string_view text,
+                                              size_t count) {
+  count = std::max<size_t>(1, std::min(count, text.size() / kMinChunkSize));
+  std::vector<std::string_view> chunks;
+  size_t chunk_start = 0;
+  for (size_t chunk = 1; chunk <= count && chunk_start < text.size();
+       ++chunk) {
+    size_t chunk_end = text.size();
+    if (chunk < count) {
+      chunk_end = text.find('\n', text.size() / count * chunk);
+      chunk_end = chunk_end == std::string_view::npos ? text.size()
+                                                      : chunk_end + 1;
+    }
+    if (chunk_end > chunk_start)
+      chunks.push_back(text.substr(chunk_start, chunk_end - chunk_start));
+    chunk_start = std::max(chunk_start, chunk_end);
+  }
+  if (chunks.empty())
+    chunks.push_back(text);
+  return chunks;
+}
+
+/**
+ * @brief Splits a text into valid word pairs sorted by KeyedLess.
+ * @param text Lines "english:russian"
+ * @return Sorted views into the text
+ */
+std::vector<KeyedView> SortWordPairs(std::string_view text) {
+  std::vector<std::pair<std::string_view, std::string_view>> split =
+      utils::SplitWordPairs(text);
+  std::vector<KeyedView> views;
+  views.reserve(split.size());
+  for (const auto &[english, russian] : split)
+    views.push_back(KeyedView{utils::PackPrefix(english), english, russian});
+  // Files written by operator<< are sorted already
+  if (!std::is_sorted(views.begin(), views.end(), KeyedLess))
+    std::sort(views.begin(), views.end(), KeyedLess);
+  return views;
 }
-bool Dictionary::LoadFromFile(const std::string &filename) {
-  std::ifstream file(filename);
-  if (!file.is_open()) {
+
+/**
+ * @brief Splits and sorts parts of a text in parallel.
+ *
+ * The text is cut into parts at ends of lines, each part is sorted as
+ * views into the text by a thread of its own.
+ *
+ * @param text Lines "english:russian"
+ * @param thread_count Desired number of parts
+ * @return Sorted runs of views
+ */
+std::vector<std::vector<KeyedView>> SortChunks(std::string_view text,
+                                               size_t thread_count) {
+  std::vector<std::string_view> chunks = SplitIntoChunks(text, thread_count);
+  std::vector<std::vector<KeyedView>> runs(chunks.size());
+  if (chunks.size() == 1) {
+    runs[0] = SortWordPairs(chunks[0]);
+    return runs;
+  }
+  std::vector<std::future<std::vector<KeyedView>>> sorted_runs;
+  for (std::string_view chunk : chunks) {
+    sorted_runs.push_back(
+        std::async(std::launch::async, SortWordPairs, chunk));
+  }
+  for (size_t run = 0; run < runs.size(); ++run)
+    runs[run] = sorted_runs[run].get();
+  return runs;
+}
+
+/**
+ * @brief Merges sorted runs, passing every word once.
+ *
+ * Of repeated words only the last one in the text is passed, the merge
+ * yields it last among equal words.
+ *
+ * @tparam Func Callable as func(std::string\_view english\_word,
+ * std::string\_view russian\_word)
+ * @param runs Runs sorted by KeyedLess
+ * @param func Function called for each word in alphabetical order
+ */
+template <typename Func>
+void MergeRuns(const std::vector<std::vector<KeyedView>> &runs, Func func) {
+  const KeyedView *pending = nullptr;
+  auto take = [&](const KeyedView &view) {
+    if (pending && pending->english != view.english)
+      func(pending->english, pending->russian);
+    pending = &view;
+  };
+  if (runs.size() == 1) {
+    for (const KeyedView &view : runs[0])
+      take(view);
+  } else {
+    // Heads of the runs in a heap, the least one on top
+    using Head = std::pair<const KeyedView *, const KeyedView *>;
+    auto greater = [](const Head &first, const Head &second) {
+      return KeyedLess(*second.first, *first.first);
+    };
+    std::vector<Head> heads;
+    for (const std::vector<KeyedView> &run : runs) {
+      if (!run.empty())
+        heads.emplace_back(run.data(), run.data() + run.size());
+    }
+    std::make_heap(heads.begin(), heads.end(), greater);
+    while (!heads.empty()) {
+      std::pop_heap(heads.begin(), heads.end(), greater);
+      Head &head = heads.back();
+      take(*head.first);
+      if (++head.first == head.second) {
+        heads.pop_back();
+      } else {
+        std::push_heap(heads.begin(), heads.end(), greater);
+      }
+    }
+  }
+  if (pending)
+    func(pending->english, pending->russian);
+}
+
+} // namespace
+
+std::vector<std::pair<Dictionary::String, Dictionary::String>>
+Dictionary::ReadWordPairs(std::string_view text,
+                          std::pmr::memory_resource *resource,
+                          size_t thread_count) {
+  // Parts are split and sorted in parallel as views into the text. The
+  // memory resource need not be thread-safe, so words are copied into it
+  // only by this thread while the sorted runs are merged
+  std::vector<std::vector<KeyedView>> runs = SortChunks(text, thread_count);
+  size_t total_size = 0;
+  for (const std::vector<KeyedView> &run : runs)
+    total_size += run.size();
+  std::vector<std::pair<String, String>> word_pairs;
+  word_pairs.reserve(total_size);
+  MergeRuns(runs, [&word_pairs, resource](std::string_view english_word,
+                                          std::string_view russian_word) {
+    word_pairs.emplace_back(String(english_word, resource),
+                            String(russian_word, resource));
+  });
+  return word_pairs;
+}
+
+bool Dictionary::SaveBinary(const std::string &filename) const {
+  BinaryDictionary::Writer writer(filename);
+  for (const auto &[english_word, russian_word] : container_)
+    writer.Add(english_word, russian_word);
+  return writer.Finish();
+}
+bool Dictionary::ConvertToBinary(const std::string &text_filename,
+                                 const std::string &binary_filename,
+                                 size_t thread_count) {
+  std::optional<MappedFile> file;
+  try {
+    file.emplace(text_filename);
+  } catch (const std::system_error &exception) {
     return false;
   }
-  Clear();
-  file >> *this;
-  bool success = file.eof() || file.good();
-  file.close();
-  return success;
+  if (thread_count == 0)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  BinaryDictionary::Writer writer(binary_filename);
+  MergeRuns(SortChunks(file->GetContents(), thread_count),
+            [&writer](std::string_view english_word,
+                      std::string_view russian_word) {
+              writer.Add(english_word, russian_word);
+            });
+  return writer.Finish();
+}
+
+Dictionary::Range Dictionary::FindRange(const std::string &first_word,
+                                        const std::string &last_word) const {
+  if (!utils::IsEnglishWord(first_word) || !utils::IsEnglishWord(last_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: range bounds must be english");
+  }
+  if (last_word < first_word)
+    return {container_.end(), container_.end()};
+  return {container_.lower_bound(std::string_view(first_word)),
+          container_.upper_bound(std::string_view(last_word))};
+}
+Dictionary::Range Dictionary::FindPrefix(const std::string &prefix) const {
+  if (prefix.empty())
+    return {container_.begin(), container_.end()};
+  if (!utils::IsEnglishWord(prefix)) {
+    throw std::invalid_argument(
+        "Invalid argument format: prefix must be english");
+  }
+  PrefixEnd prefix_end(prefix);
+  return {container_.lower_bound(std::string_view(prefix)),
+          prefix_end.Get().empty() ? container_.end()
+                                   : container_.lower_bound(prefix_end.Get())};
+}
+
+std::vector<const Dictionary::WordPair *>
+Dictionary::Complete(std::string_view prefix, size_t count) const {
+  if (!prefix.empty() && !utils::IsEnglishWord(prefix)) {
+    throw std::invalid_argument(
+        "Invalid argument format: prefix must be english");
+  }
+  // Matching words take positions [first, last) in alphabetical order
+  PrefixEnd prefix_end(prefix);
+  size_t first = container_.Rank(prefix);
+  size_t last = prefix_end.Get().empty() ? GetSize()
+                                         : container_.Rank(prefix_end.Get());
+  count = std::min(count, last - first);
+  std::vector<const WordPair *> completions;
+  completions.reserve(count);
+  if (weights_.IsEmpty()) {
+    // All weights are equal, the first matching words are the heaviest
+    for (const_iterator it = container_.lower_bound(prefix);
+         completions.size() < count; ++it) {
+      completions.push_back(&*it);
+    }
+    return completions;
+  }
+  if (completion_stale_)
+    RebuildCompletionIndex();
+  completion_.TopK(first, last, count,
+                   [&completions](const WordPair &word_pair) {
+                     completions.push_back(&word_pair);
+                   });
+  return completions;
+}
+void Dictionary::SetWeight(std::string_view english_word, uint64_t weight) {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: word must be english");
+  }
+  if (!container_.Contains(english_word)) {
+    throw std::out_of_range("Word not found: " + std::string(english_word));
+  }
+  if (weight == 0) {
+    weights_.Erase(english_word);
+  } else {
+    auto [word_weight, added] =
+        weights_.TryEmplace(MakeString(english_word), weight);
+    if (!added)
+      word_weight->second = weight;
+  }
+  // Positions are unchanged, so a built index is updated in place
+  if (!completion_stale_)
+    completion_.SetWeight(container_.Rank(english_word), weight);
+}
+
+size_t Dictionary::Rank(std::string_view english_word) const {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: word must be english");
+  }
+  return container_.Rank(english_word);
+}
+size_t Dictionary::CountRange(std::string_view first_word,
+                              std::string_view last_word) const {
+  if (!utils::IsEnglishWord(first_word) || !utils::IsEnglishWord(last_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: range bounds must be english");
+  }
+  return container_.CountRange(first_word, last_word);
+}
+
+void Dictionary::AddWordPair(std::string_view english_word,
+                             std::string_view russian_word) {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: first word must be english");
+  }
+  if (!utils::IsRussianWord(russian_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: second word must be russian");
+  }
+  // Present words are updated in place, strings are made only for new ones
+  if (hash_index_) {
+    if (WordPair *word_pair = index_.Find(english_word)) {
+      word_pair->second.assign(russian_word);
+      return;
+    }
+    // Growing the index first leaves nothing to fail after the tree changed
+    index_.Reserve(index_.GetSize() + 1);
+  } else {
+    Container::iterator found = container_.lower_bound(english_word);
+    if (found != container_.end() && found->first == english_word) {
+      found->second.assign(russian_word);
+      return;
+    }
+  }
+  Container::iterator added =
+      container_
+          .TryEmplace(MakeString(english_word), MakeString(russian_word))
+          .first;
+  completion_stale_ = true;
+  if (hash_index_)
+    index_.Insert(&*added);
+}
+
+void Dictionary::Merge(const Dictionary &other, MergePolicy policy) {
+  completion_stale_ = true;
+  // Union keeps nodes of common words, only added pairs need indexing.
+  // Growing the index first makes indexing them unable to fail
+  if (hash_index_)
+    index_.Reserve(index_.GetSize() + other.GetSize());
+  auto index_added = [this](WordPair &word_pair) {
+    if (hash_index_)
+      index_.Insert(&word_pair);
+  };
+  try {
+    if (policy == MergePolicy::kOverwrite) {
+      container_.Union(
+          other.container_,
+          [](String &translation, const String &other_translation) {
+            translation = other_translation;
+          },
+          index_added);
+    } else {
+      container_.Union(
+          other.container_, [](String &, const String &) {}, index_added);
+    }
+  } catch (...) {
+    RebuildHashIndex();
+    throw;
+  }
+}
+
+void Dictionary::SetHashIndex(bool enabled) {
+  hash_index_ = enabled;
+  RebuildHashIndex();
+}
+void Dictionary::RebuildCompletionIndex() const {
+  // Both trees are sorted, so weights are matched to words in one pass
+  Weights::const_iterator weight = weights_.begin();
+  auto weight_of = [this, &weight](const WordPair &word_pair) -> uint64_t {
+    while (weight != weights_.end() && weight->first < word_pair.first)
+      ++weight;
+    if (weight != weights_.end() && weight->first == word_pair.first)
+      return weight->second;
+    return 0;
+  };
+  completion_.Assign(container_.begin(), container_.end(), weight_of);
+  completion_stale_ = false;
+}
+void Dictionary::DropAbsentWeights() {
+  std::vector<std::string> absent_words;
+  for (const auto &[english_word, weight] : weights_) {
+    if (!container_.Contains(std::string_view(english_word)))
+      absent_words.emplace_back(english_word);
+  }
+  for (const std::string &english_word : absent_words)
+    weights_.Erase(std::string_view(english_word));
+}
+void Dictionary::RebuildHashIndex() {
+  index_.Clear();
+  if (!hash_index_) {
+    index_ = Index(GetMemoryResource());
+    return;
+  }
+  try {
+    index_.Reserve(container_.GetSize());
+  } catch (...) {
+    // Lookups fall back to the tree rather than miss words
+    hash_index_ = false;
+    throw;
+  }
+  for (WordPair &word_pair : container_)
+    index_.Insert(&word_pair);
 }
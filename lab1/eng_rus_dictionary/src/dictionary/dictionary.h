@@ -8,7 +8,8 @@
  *
  * @section features_sec Key Features
  *
- * - Fast O(log n) average lookup time
+ * - Guaranteed O(log n) lookup time (AVL-balanced tree), O(1) on average
+ *   for exact lookups with the optional hash index
  * - Alphabetically sorted word pairs
  * - Support for adding and removing translations
  * - File I/O operations for loading dictionaries
@@ -40,11 +41,20 @@
 #ifndef DICTIONARY_H
 #define DICTIONARY_H
 
+#include "../binary_dictionary/binary_dictionary.h"
 #include "../binary_search_tree/binary_search_tree.hpp"
+#include "../completion_index/completion_index.hpp"
+#include "../hash_index/hash_index.hpp"
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 /**
  * @brief English-Russian dictionary class.
@@ -52,16 +62,74 @@
  * This class provides a dictionary that maps English words to their Russian
  * translations. It uses a binary search tree internally for efficient lookup
  * and maintains alphabetical ordering.
+ *
+ * Tree nodes and stored words are allocated from a std::pmr::memory\_resource,
+ * the default one unless given to the constructor. A short-lived dictionary
+ * can be placed in a std::pmr::monotonic\_buffer\_resource and released
+ * together with the buffer.
+ *
+ * Exact lookups (Find, Contains, operator[]) can be served by an optional
+ * hash index kept next to the tree, see SetHashIndex. Ordered operations
+ * always use the tree. Words may be given frequency weights for
+ * as-you-type completion, see Complete.
  */
 class Dictionary {
 public:
+  /// CollectStatistics if DICTIONARY\_STATISTICS is defined in every
+  /// translation unit, then Stats() also reports lookup comparisons
+#ifdef DICTIONARY_STATISTICS
+  using StatisticsPolicy = CollectStatistics;
+#else
+  using StatisticsPolicy = NoStatistics;
+#endif
+  /**
+   * @brief Type of stored words, allocated from the dictionary's memory
+   * resource.
+   *
+   * operator[], Find, LookupBatch, iterators and Diff give words of this
+   * type, not std::string. A std::string is made explicitly, e.g.
+   * std::string translation(dict["hello"]).
+   */
+  using String = std::pmr::string;
+  /// Word pair stored in the tree
+  using WordPair = std::pair<const String, String>;
+  /// Type of the internal storage of word pairs
+  using Container =
+      BinarySearchTree<String, String, AvlBalancing,
+                       PoolNodeAllocation, std::less<>, OrderStatistics,
+                       StatisticsPolicy>;
+  /// Read-only iterator over word pairs in alphabetical order
+  using const_iterator = Container::const_iterator;
+  /// Half-open range [first, second) of word pairs
+  using Range = std::pair<const_iterator, const_iterator>;
+  /// How Merge resolves words present in both dictionaries
+  enum class MergePolicy {
+    kOverwrite,   ///< Translation from the merged dictionary wins
+    kKeepExisting ///< Translation already in this dictionary wins
+  };
+
   /**
    * @brief Default constructor. Creates an empty dictionary.
    */
   Dictionary() = default;
 
+  /**
+   * @brief Creates an empty dictionary taking all memory from a resource.
+   * @param resource Memory resource that outlives the dictionary
+   * @code
+   * std::array<std::byte, 4096> buffer;
+   * std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+   * Dictionary glossary(&arena);
+   * glossary += "hello:привет"; // nodes and words are placed in buffer
+   * @endcode
+   */
+  explicit Dictionary(std::pmr::memory_resource *resource);
+
   /**
    * @brief Copy constructor. Creates a deep copy of another dictionary.
+   *
+   * The copy uses the memory resource of other.
+   *
    * @param other Dictionary to copy from
    * @code
    * Dictionary dict1;
@@ -73,7 +141,7 @@ public:
   Dictionary(const Dictionary &other);
 
   /**
-   * @brief Copy assignment operator.
+   * @brief Copy assignment operator. Keeps own memory resource.
    * @param other Dictionary to copy from
    * @return Reference to this dictionary
    * @code
@@ -85,6 +153,19 @@ public:
    */
   Dictionary &operator=(const Dictionary &other);
 
+  /**
+   * @brief Move constructor. Takes all word pairs of another dictionary.
+   * @param other Dictionary to move from, left empty
+   */
+  Dictionary(Dictionary &&other) noexcept = default;
+
+  /**
+   * @brief Move assignment operator.
+   * @param other Dictionary to move from, left empty
+   * @return Reference to this dictionary
+   */
+  Dictionary &operator=(Dictionary &&other) noexcept = default;
+
   /**
    * @brief Destructor. Automatically cleans up all resources.
    */
@@ -102,6 +183,37 @@ public:
    */
   Dictionary &operator+=(const std::pair<std::string, std::string> &word_pair);
 
+  /**
+   * @brief Adds a word pair to the dictionary.
+   *
+   * Words are copied into the memory resource of the dictionary.
+   *
+   * @param word_pair Pair of English word, Russian translation
+   * @return Reference to this dictionary for chaining
+   * @throw std::invalid\_argument if word format is invalid
+   */
+  Dictionary &operator+=(std::pair<std::string, std::string> &&word_pair);
+
+  /**
+   * @brief Adds a pair of String words, e.g. taken from a dictionary.
+   *
+   * A template, so that pairs of C-strings still pick the std::string
+   * overload.
+   *
+   * @param word_pair Pair of English word, Russian translation
+   * @return Reference to this dictionary for chaining
+   * @throw std::invalid\_argument if word format is invalid
+   */
+  template <typename Pair,
+            typename = std::enable_if_t<
+                std::is_same_v<std::remove_const_t<typename Pair::first_type>,
+                               String> &&
+                std::is_same_v<typename Pair::second_type, String>>>
+  Dictionary &operator+=(const Pair &word_pair) {
+    AddWordPair(word_pair.first, word_pair.second);
+    return *this;
+  }
+
   /**
    * @brief Adds a word pair from a string in format "english:russian".
    * @param word_pair String containing colon-separated word pair
@@ -161,19 +273,34 @@ public:
    */
   Dictionary &operator-=(const char *english_word);
 
+  /**
+   * @brief Removes a word pair from the dictionary without allocating.
+   * @param english_word English word to remove
+   * @return Reference to this dictionary for chaining
+   * @throw std::invalid\_argument if word is not valid English
+   * @throw std::out\_of\_range if word not found
+   */
+  Dictionary &operator-=(std::string_view english_word);
+
   /**
    * @brief Accesses translation of an English word (const version).
+   *
+   * Takes std::string_view, so lookups from text buffers, std::string or
+   * C-strings don't construct a temporary key.
+   *
    * @param english_word English word to look up
    * @return Const reference to Russian translation
    * @throw std::invalid\_argument if word is not valid English
    * @throw std::out\_of\_range if word not found
    */
-  const std::string &operator[](const std::string &english_word) const;
+  const String &operator[](std::string_view english_word) const;
 
   /**
    * @brief Accesses or creates translation of an English word.
    *
    * If word doesn't exist, creates an entry with empty translation.
+   * Takes std::string\_view like the const version, so looking up a
+   * present word allocates nothing, only a new entry copies the word.
    *
    * @param english_word English word to look up or create
    * @return Reference to Russian translation
@@ -184,7 +311,74 @@ public:
    * std::cout << dict["hello"]; // Outputs: привет
    * @endcode
    */
-  std::string &operator[](const std::string &english_word);
+  String &operator[](std::string_view english_word);
+
+  /**
+   * @brief Looks up translation of a word without allocating or throwing.
+   * @param english_word Word to look up
+   * @return Pointer to Russian translation, nullptr if word is not present
+   * @code
+   * Dictionary dict;
+   * dict += "hello:привет";
+   * std::string_view text = "hello world";
+   * if (const auto *translation = dict.Find(text.substr(0, 5))) {
+   *   std::cout << *translation; // Outputs: привет
+   * }
+   * @endcode
+   */
+  const String *Find(std::string_view english_word) const {
+    if (hash_index_) {
+      const WordPair *word_pair = index_.Find(english_word);
+      return word_pair ? &word_pair->second : nullptr;
+    }
+    return container_.Find(english_word);
+  }
+
+  /**
+   * @brief Looks up translations of many words at once.
+   *
+   * Lookups of different words are interleaved so that their cache misses
+   * overlap, which makes translating a long text several times faster than
+   * calling Find for every word when the dictionary doesn't fit in cache.
+   * Uses the hash index if it is on.
+   *
+   * @param english_words Words to look up
+   * @param count Number of words
+   * @return Pointers to translations in the order of words, nullptr for
+   * absent ones
+   * @code
+   * Dictionary dict;
+   * dict += "hello:привет";
+   * std::vector<std::string_view> text = {"hello", "world"};
+   * auto translations = dict.LookupBatch(text.data(), text.size());
+   * std::cout << *translations[0]; // Outputs: привет
+   * // translations[1] == nullptr
+   * @endcode
+   */
+  std::vector<const String *> LookupBatch(const std::string_view *english_words,
+                                          size_t count) const;
+
+  /**
+   * @brief Looks up translations of all words of a vector at once.
+   * @param english_words Words to look up
+   * @return Pointers to translations in the order of words, nullptr for
+   * absent ones
+   */
+  std::vector<const String *>
+  LookupBatch(const std::vector<std::string_view> &english_words) const {
+    return LookupBatch(english_words.data(), english_words.size());
+  }
+
+  /**
+   * @brief Checks if the dictionary contains a word.
+   * @param english_word Word to look up
+   * @return true if word is present
+   */
+  bool Contains(std::string_view english_word) const {
+    if (hash_index_)
+      return index_.Find(english_word) != nullptr;
+    return container_.Contains(english_word);
+  }
 
   /**
    * @brief Equality comparison operator.
@@ -256,7 +450,13 @@ public:
   /**
    * @brief Removes all entries from the dictionary.
    */
-  void Clear() { container_.Clear(); }
+  void Clear() {
+    container_.Clear();
+    index_.Clear();
+    weights_.Clear();
+    completion_.Clear();
+    completion_stale_ = true;
+  }
 
   /**
    * @brief Returns the number of word pairs in the dictionary.
@@ -274,17 +474,356 @@ public:
    * @brief Loads dictionary from a text file.
    *
    * File should contain one word pair per line in format "english:russian".
-   * Clears current dictionary before loading.
+   * Invalid lines are skipped, for repeated English words the last line
+   * wins. Current contents are replaced: the file is mapped into memory
+   * (read into one buffer where mmap is not available, see MappedFile) and
+   * split into views of its words, the views are sorted once, then every
+   * word is copied once into the memory resource and the tree is built in
+   * linear time.
+   *
+   * With several threads the file is cut into parts at ends of lines, each
+   * part is split and sorted by its own thread, and the sorted parts are
+   * merged. The result doesn't depend on the number of threads.
    *
    * @param filename Path to file to load
+   * @param thread_count Number of threads sorting parts of the file, 0 for
+   * one per hardware thread
    * @return true if file was successfully loaded, false if file couldn't be
    * opened
    */
-  bool LoadFromFile(const std::string &filename);
+  bool LoadFromFile(const std::string &filename, size_t thread_count = 1);
+
+  /**
+   * @brief Saves dictionary as a binary sorted string table.
+   *
+   * The file is opened by OpenBinary without parsing or building a tree,
+   * see BinaryDictionary for the format.
+   *
+   * @param filename Path to file to write
+   * @return true if file was written, false if it couldn't be
+   */
+  bool SaveBinary(const std::string &filename) const;
+
+  /**
+   * @brief Opens a file written by SaveBinary or ConvertToBinary.
+   *
+   * Maps the file and checks its header, lookups read the file directly.
+   *
+   * @param filename Path to file to open
+   * @return Read-only dictionary over the file
+   * @throw std::system\_error if the file can't be opened or mapped
+   * @throw std::runtime\_error if the file is not a binary dictionary
+   */
+  static BinaryDictionary OpenBinary(const std::string &filename) {
+    return BinaryDictionary(filename);
+  }
+
+  /**
+   * @brief Converts a text dictionary file into a binary one.
+   *
+   * Reads the text as LoadFromFile does but writes the sorted word pairs
+   * straight to the binary file without building a tree.
+   *
+   * @param text_filename Path to text file with "english:russian" lines
+   * @param binary_filename Path to binary file to write
+   * @param thread_count Number of threads sorting parts of the text, 0 for
+   * one per hardware thread
+   * @return true if the binary file was written, false if the text file
+   * couldn't be opened or the binary file couldn't be written
+   */
+  static bool ConvertToBinary(const std::string &text_filename,
+                              const std::string &binary_filename,
+                              size_t thread_count = 1);
+
+  /**
+   * @brief Returns iterator to the alphabetically first word pair.
+   */
+  const_iterator begin() const { return container_.begin(); }
+
+  /**
+   * @brief Returns iterator past the last word pair.
+   */
+  const_iterator end() const { return container_.end(); }
+
+  /**
+   * @brief Finds all word pairs with English word in [first_word, last_word].
+   *
+   * Only the returned word pairs and one path from the root are visited.
+   *
+   * @param first_word Lower bound of the range, inclusive
+   * @param last_word Upper bound of the range, inclusive
+   * @return Range of matching word pairs, empty if last_word < first_word
+   * @throw std::invalid\_argument if bounds are not valid English words
+   * @code
+   * Dictionary dict;
+   * dict += "apple:яблоко";
+   * dict += "food:еда";
+   * dict += "mine:добывать";
+   * auto range = dict.FindRange("b", "m");
+   * for (auto it = range.first; it != range.second; ++it) {
+   *   std::cout << it->first << " "; // Outputs: food
+   * }
+   * @endcode
+   */
+  Range FindRange(const std::string &first_word,
+                  const std::string &last_word) const;
+
+  /**
+   * @brief Finds all word pairs whose English word starts with prefix.
+   * @param prefix Beginning of English words, empty prefix matches all
+   * @return Range of matching word pairs
+   * @throw std::invalid\_argument if prefix is not valid English
+   * @code
+   * Dictionary dict;
+   * dict += "apple:яблоко";
+   * dict += "application:приложение";
+   * dict += "food:еда";
+   * auto range = dict.FindPrefix("app");
+   * for (auto it = range.first; it != range.second; ++it) {
+   *   std::cout << it->first << " "; // Outputs: apple application
+   * }
+   * @endcode
+   */
+  Range FindPrefix(const std::string &prefix) const;
+
+  /**
+   * @brief Completes a prefix with the most frequent words.
+   *
+   * Words starting with the prefix are found by rank in the tree, O(log n).
+   * Without weights they are the first count of them in alphabetical
+   * order. With weights the heaviest ones are taken from an index of
+   * weights by position in O(count log n), however many words match.
+   * The index is built by the first call after words were added or
+   * removed, in O(n), so unlike other const methods Complete must not be
+   * called from several threads at once.
+   *
+   * @param prefix Beginning of English words, empty prefix matches all
+   * @param count Maximum number of completions
+   * @return Matching word pairs, heaviest first, of equal weights
+   * alphabetical
+   * @throw std::invalid\_argument if prefix is not valid English
+   * @code
+   * Dictionary dict;
+   * dict += "apple:яблоко";
+   * dict += "application:приложение";
+   * dict += "apply:применять";
+   * dict.SetWeight("apply", 10);
+   * for (const Dictionary::WordPair *word_pair : dict.Complete("app", 2)) {
+   *   std::cout << word_pair->first << " "; // Outputs: apply apple
+   * }
+   * @endcode
+   */
+  std::vector<const WordPair *> Complete(std::string_view prefix,
+                                         size_t count) const;
+
+  /**
+   * @brief Sets frequency weight of a word for Complete.
+   *
+   * Weights are kept while the word stays in the dictionary, copied
+   * together with it and not compared by operator==. LoadFromFile keeps
+   * weights of words present in the file.
+   *
+   * @param english_word Word in the dictionary
+   * @param weight New weight, 0 (the default) removes it
+   * @throw std::invalid\_argument if word is not valid English
+   * @throw std::out\_of\_range if word not found
+   */
+  void SetWeight(std::string_view english_word, uint64_t weight);
+
+  /**
+   * @brief Returns frequency weight of a word.
+   * @param english_word Word to look up
+   * @return Weight set by SetWeight, 0 if none or word is absent
+   */
+  uint64_t GetWeight(std::string_view english_word) const {
+    const uint64_t *weight = weights_.Find(english_word);
+    return weight ? *weight : 0;
+  }
+
+  /**
+   * @brief Returns word pair with given position in alphabetical order.
+   * @param index Zero-based position of the word
+   * @return Iterator to the word pair, end() if index >= GetSize()
+   */
+  const_iterator Select(size_t index) const {
+    return container_.Select(index);
+  }
+
+  /**
+   * @brief Counts words alphabetically less than the given one.
+   * @param english_word Word to rank, need not be in the dictionary
+   * @return Position the word has or would have in alphabetical order
+   * @throw std::invalid\_argument if word is not valid English
+   */
+  size_t Rank(std::string_view english_word) const;
+
+  /**
+   * @brief Counts words in [first_word, last_word] in O(log n).
+   * @param first_word Lower bound of the range, inclusive
+   * @param last_word Upper bound of the range, inclusive
+   * @return Number of words in the range, 0 if last_word < first_word
+   * @throw std::invalid\_argument if bounds are not valid English words
+   */
+  size_t CountRange(std::string_view first_word,
+                    std::string_view last_word) const;
+
+  /**
+   * @brief Describes shape and memory use of the internal tree in O(n).
+   *
+   * Lookup and comparison counters are zero unless the dictionary is built
+   * with DICTIONARY\_STATISTICS defined.
+   *
+   * @return Depth histogram, node memory and lookup counters
+   */
+  TreeStatistics Stats() const { return container_.GetStatistics(); }
+
+  /**
+   * @brief Turns the hash index of exact lookups on or off.
+   *
+   * The index maps every word to its pair in the tree and is updated by
+   * all modifications, so Find, Contains and operator[] of present words
+   * take O(1) on average instead of O(log n) string comparisons. It costs
+   * one table of 16-byte slots, at most 3/4 full, taken from the memory
+   * resource of the dictionary. Turning it on indexes all words in O(n),
+   * turning it off frees the table. A copy constructed from a dictionary
+   * inherits its setting, copy assignment keeps own one.
+   *
+   * @param enabled true to build the index, false to drop it
+   * @code
+   * Dictionary dict;
+   * dict.SetHashIndex(true);
+   * dict += "hello:привет";
+   * std::cout << dict["hello"]; // Outputs: привет, found by hash
+   * @endcode
+   */
+  void SetHashIndex(bool enabled);
+
+  /**
+   * @brief Checks whether exact lookups use the hash index.
+   */
+  bool HasHashIndex() const { return hash_index_; }
+
+  /**
+   * @brief Returns the memory resource of nodes and words.
+   */
+  std::pmr::memory_resource *GetMemoryResource() const {
+    return container_.GetMemoryResource();
+  }
+
+  /**
+   * @brief Adds all word pairs of another dictionary.
+   *
+   * Merging m words into n takes O(m log(n / m + 1)), much less than
+   * adding words one by one when a small glossary is merged into a large
+   * dictionary or the other way round.
+   *
+   * @param other Dictionary to take word pairs from
+   * @param policy Which translation to keep for words present in both
+   * @code
+   * Dictionary dict;
+   * dict += "hello:привет";
+   * Dictionary glossary;
+   * glossary += "hello:здравствуй";
+   * glossary += "world:мир";
+   * dict.Merge(glossary, Dictionary::MergePolicy::kKeepExisting);
+   * std::cout << dict; // Outputs: hello:привет world:мир
+   * @endcode
+   */
+  void Merge(const Dictionary &other,
+             MergePolicy policy = MergePolicy::kOverwrite);
+
+  /**
+   * @brief Reports word pairs that differ from another dictionary.
+   *
+   * Walks both dictionaries once in alphabetical order, O(n + m). Applying
+   * the reported changes to this dictionary makes it equal to other, so
+   * they can be shipped as an incremental update.
+   *
+   * @param other Newer version of the dictionary
+   * @param on_added Called as on\_added(word, translation) for words only
+   * in other
+   * @param on_removed Called as on\_removed(word, translation) for words
+   * only in this dictionary
+   * @param on_changed Called as on\_changed(word, old\_translation,
+   * new\_translation) for words translated differently
+   * @code
+   * Dictionary old_dict, new_dict;
+   * old_dict += "hello:привет";
+   * new_dict += "hello:здравствуй";
+   * old_dict.Diff(
+   *     new_dict, [](const auto &, const auto &) {},
+   *     [](const auto &, const auto &) {},
+   *     [](const auto &word, const auto &, const auto &translation) {
+   *       std::cout << word << ":" << translation; // hello:здравствуй
+   *     });
+   * @endcode
+   */
+  template <typename OnAdded, typename OnRemoved, typename OnChanged>
+  void Diff(const Dictionary &other, OnAdded on_added, OnRemoved on_removed,
+            OnChanged on_changed) const {
+    container_.Diff(other.container_, on_added, on_removed, on_changed);
+  }
 
 private:
-  BinarySearchTree<std::string, std::string>
-      container_; ///< Internal storage of the pairs
+  /// Side index from words to their pairs in the tree
+  using Index = HashIndex<WordPair>;
+  /// Nonzero weights of words, the default is 0
+  using Weights = BinarySearchTree<String, uint64_t, AvlBalancing,
+                                   PoolNodeAllocation, std::less<>>;
+
+  Container container_;     ///< Internal storage of the pairs
+  Index index_;             ///< Index of all pairs if hash\_index\_ is set
+  bool hash_index_ = false; ///< true if exact lookups go through index\_
+  Weights weights_;         ///< Weights set by SetWeight
+  /// Weights of all pairs by position, built by Complete on demand
+  mutable CompletionIndex<WordPair> completion_;
+  /// true if words were added or removed since completion\_ was built
+  mutable bool completion_stale_ = true;
+
+  /**
+   * @brief Indexes all word pairs anew if the hash index is on.
+   */
+  void RebuildHashIndex();
+
+  /**
+   * @brief Indexes weights of all word pairs for Complete in O(n).
+   */
+  void RebuildCompletionIndex() const;
+
+  /**
+   * @brief Drops weights of words no longer in the dictionary.
+   */
+  void DropAbsentWeights();
+
+  /**
+   * @brief Validates words and inserts them, copied into own resource.
+   * @param english_word English word
+   * @param russian_word Its Russian translation
+   * @throw std::invalid\_argument if word format is invalid
+   */
+  void AddWordPair(std::string_view english_word,
+                   std::string_view russian_word);
+
+  /**
+   * @brief Copies a word into the memory resource of the dictionary.
+   * @param word Word to copy
+   * @return Copy allocated from GetMemoryResource()
+   */
+  String MakeString(std::string_view word) const {
+    return String(word, GetMemoryResource());
+  }
+
+  /**
+   * @brief Reads all valid word pairs from contents of a dictionary file.
+   * @param text One "english:russian" pair per line
+   * @param resource Memory resource for the words
+   * @param thread_count Number of threads sorting parts of the text
+   * @return Pairs sorted by English word, of repeated words the last one,
+   * invalid lines skipped
+   */
+  static std::vector<std::pair<String, String>>
+  ReadWordPairs(std::string_view text, std::pmr::memory_resource *resource,
+                size_t thread_count);
 };
 
 #endif // DICTIONARY_H
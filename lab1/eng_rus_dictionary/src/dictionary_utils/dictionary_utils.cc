@@ -6,34 +6,11 @@
  */
 
 #include "dictionary_utils.h"
-#include <cctype>
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <sstream>
 
-bool utils::IsEnglishWord(const std::string &word) {
-  if (word.empty()) {
-    return false;
-  }
-  for (unsigned char c : word) {
-    if (c == '-' || isspace(c))
-      continue;
-    if (!std::isalpha(c) || c > ASCII_BORDER) {
-      return false;
-    }
-  }
-  return true;
-}
-bool utils::IsRussianWord(const std::string &word) {
-  if (word.empty()) {
-    return false;
-  }
-  for (unsigned char c : word) {
-    if (c == '-' || isspace(c))
-      continue;
-    if (c <= ASCII_BORDER)
-      return false;
-  }
-  return true;
-}
 void utils::ParseWordPair(std::string &english, std::string &russian,
                           const std::string &pair) {
   if (pair.empty() || pair == std::string(1, WORD_PAIR_DELIMETER)) {
@@ -43,3 +20,45 @@ void utils::ParseWordPair(std::string &english, std::string &russian,
   std::getline(sstream, english, WORD_PAIR_DELIMETER);
   std::getline(sstream, russian, WORD_PAIR_DELIMETER);
 }
+std::vector<std::pair<std::string_view, std::string_view>>
+utils::SplitWordPairs(std::string_view text) {
+  std::vector<std::pair<std::string_view, std::string_view>> word_pairs;
+  // Counting lines first is cheaper than growing the vector
+  word_pairs.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+  const char *position = text.data();
+  const char *end = position + text.size();
+  while (position < end) {
+    const char *line_end = static_cast<const char *>(
+        std::memchr(position, '\n', end - position));
+    if (!line_end)
+      line_end = end;
+    std::string_view english, russian;
+    if (SplitWordPair(std::string_view(position, line_end - position),
+                      english, russian)) {
+      word_pairs.emplace_back(english, russian);
+    }
+    // end + 1 would point past the buffer
+    position = line_end == end ? end : line_end + 1;
+  }
+  return word_pairs;
+}
+uint64_t utils::PackPrefix(std::string_view word) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    unsigned char byte = i < word.size() ? word[i] : 0;
+    prefix = (prefix << 8) | byte;
+  }
+  return prefix;
+}
+std::string_view utils::NextPrefix(std::string_view prefix, char *buffer) {
+  while (!prefix.empty() &&
+         static_cast<unsigned char>(prefix.back()) == UCHAR_MAX) {
+    prefix.remove_suffix(1);
+  }
+  if (prefix.empty())
+    return {};
+  std::copy(prefix.begin(), prefix.end(), buffer);
+  unsigned char last = static_cast<unsigned char>(prefix.back());
+  buffer[prefix.size() - 1] = static_cast<char>(last + 1);
+  return {buffer, prefix.size()};
+}
@@ -5,32 +5,92 @@
  * @date 20/10/2025
  */
 
+#ifndef DICTIONARY_UTILS_H
+#define DICTIONARY_UTILS_H
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #define ASCII_BORDER 127 ///< Macros for border of ASCII symbols
 #define WORD_PAIR_DELIMETER   \
   ':' ///< Macros for word delimete of pair: word <delimeter> translation
 namespace utils {
 
+namespace detail {
+
+constexpr unsigned char kEnglish = 1; ///< Byte may occur in English words
+constexpr unsigned char kRussian = 2; ///< Byte may occur in Russian words
+
+/**
+ * @brief Builds the table of byte classes of the "C" locale.
+ *
+ * Hyphens and whitespace are allowed in words of both languages, Latin
+ * letters in English words and bytes outside ASCII in Russian ones.
+ */
+constexpr std::array<unsigned char, UCHAR_MAX + 1> MakeByteClasses() {
+  std::array<unsigned char, UCHAR_MAX + 1> classes{};
+  for (size_t c = 0; c <= UCHAR_MAX; ++c) {
+    bool is_space = c == ' ' || (c >= '\t' && c <= '\r');
+    if (c == '-' || is_space)
+      classes[c] = kEnglish | kRussian;
+    else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+      classes[c] = kEnglish;
+    else if (c > ASCII_BORDER)
+      classes[c] = kRussian;
+  }
+  return classes;
+}
+
+/// Classes of all bytes, a table lookup replaces calls into <cctype> in
+/// the inner loop of loading a file
+inline constexpr std::array<unsigned char, UCHAR_MAX + 1> kByteClasses =
+    MakeByteClasses();
+
+/**
+ * @brief Checks that a word is not empty and all its bytes have a class.
+ */
+constexpr bool HasOnly(std::string_view word, unsigned char byte_class) {
+  if (word.empty())
+    return false;
+  unsigned char common = byte_class;
+  for (unsigned char c : word)
+    common &= kByteClasses[c];
+  return common != 0;
+}
+
+} // namespace detail
+
 /**
  * @brief Checks if a string contains only English letters.
  *
- * Allows hyphens within the word. Empty strings return false.
+ * Allows hyphens within the word. Empty strings return false. Can be
+ * evaluated at compile time.
  *
  * @param word String to check
  * @return true if word contains only ASCII letters and hyphens
  */
-bool IsEnglishWord(const std::string &word);
+constexpr bool IsEnglishWord(std::string_view word) {
+  return detail::HasOnly(word, detail::kEnglish);
+}
 
 /**
  * @brief Checks if a string contains only Russian letters.
  *
- * Allows hyphens within the word. Empty strings return false.
+ * Allows hyphens within the word. Empty strings return false. Can be
+ * evaluated at compile time.
  *
  * @param word String to check
  * @return true if word contains only non-ASCII letters and hyphens
  */
-bool IsRussianWord(const std::string &word);
+constexpr bool IsRussianWord(std::string_view word) {
+  return detail::HasOnly(word, detail::kRussian);
+}
 
 /**
  * @brief Parses a colon-separated word pair.
@@ -40,4 +100,65 @@ bool IsRussianWord(const std::string &word);
  */
 void ParseWordPair(std::string &english, std::string &russian,
                    const std::string &pair);
+
+/**
+ * @brief Splits a line into a word pair without copying and checks it.
+ *
+ * Splits as ParseWordPair does: the English word ends at the first
+ * delimiter and the Russian word at the second one or at the end of line.
+ * Delimiters are found with std::string\_view::find, which is memchr at
+ * run time. Can be evaluated at compile time.
+ *
+ * @param line Line in format "english:russian"
+ * @param english Output parameter for view of English word
+ * @param russian Output parameter for view of Russian word
+ * @return true if both words are valid, outputs are unspecified otherwise
+ */
+constexpr bool SplitWordPair(std::string_view line, std::string_view &english,
+                             std::string_view &russian) {
+  size_t delimiter = line.find(WORD_PAIR_DELIMETER);
+  if (delimiter == std::string_view::npos)
+    return false;
+  english = line.substr(0, delimiter);
+  russian = line.substr(delimiter + 1);
+  russian = russian.substr(0, russian.find(WORD_PAIR_DELIMETER));
+  return IsEnglishWord(english) && IsRussianWord(russian);
+}
+
+/**
+ * @brief Splits a text into word pairs, one per line, without copying.
+ *
+ * Ends of lines are found with memchr, empty and invalid lines are
+ * skipped. The views point into text.
+ *
+ * @param text Contents of a dictionary file
+ * @return Valid pairs in the order they appear
+ */
+std::vector<std::pair<std::string_view, std::string_view>>
+SplitWordPairs(std::string_view text);
+
+/**
+ * @brief Packs first eight bytes of a word into an integer.
+ *
+ * Integers compare in the same order as the prefixes do as strings.
+ *
+ * @param word Word to pack, shorter words are padded with zeros
+ * @return Packed prefix
+ */
+uint64_t PackPrefix(std::string_view word);
+
+/**
+ * @brief Computes the smallest string greater than every string with prefix.
+ *
+ * Used as exclusive upper bound of prefix search: "app" gives "apq". The
+ * bound is never longer than the prefix, so it is written to the caller's
+ * buffer instead of a new string.
+ *
+ * @param prefix Prefix of searched strings
+ * @param buffer Storage for the bound, at least prefix.size() bytes
+ * @return View of the bound in buffer, empty if no such string exists
+ */
+std::string_view NextPrefix(std::string_view prefix, char *buffer);
 } // namespace utils
+
+#endif // DICTIONARY_UTILS_H
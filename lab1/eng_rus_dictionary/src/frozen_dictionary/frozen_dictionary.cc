@@ -0,0 +1,97 @@
+/**
+ * @file frozen_dictionary.cc
+ * @brief Implementation of FrozenDictionary class methods
+ * @author Dmitry Burbas
+ * @date 10/11/2025
+ */
+
+#include "../dictionary_utils/dictionary_utils.h"
+#include "frozen_dictionary.h"
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+FrozenDictionary::FrozenDictionary(const Dictionary &dictionary)
+    : size_(dictionary.GetSize()) {
+  size_t capacity = (size_ + 1) * sizeof(uint64_t);
+  capacity = (capacity + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+  prefixes_.reset(static_cast<uint64_t *>(
+      ::operator new(capacity, std::align_val_t(kCacheLineSize))));
+  prefixes_[0] = 0;
+  keys_.resize(size_ + 1);
+  values_.resize(size_ + 1);
+  Dictionary::const_iterator it = dictionary.begin();
+  FillHelper(it, 1);
+}
+
+const std::string *
+FrozenDictionary::Find(std::string_view english_word) const {
+  size_t index = LowerBoundIndex(english_word);
+  if (index == 0 || keys_[index] != english_word)
+    return nullptr;
+  return &values_[index];
+}
+
+const std::string &
+FrozenDictionary::operator[](std::string_view english_word) const {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: word must be english");
+  }
+  const std::string *translation = Find(english_word);
+  if (!translation) {
+    throw std::out_of_range("Word not found: " + std::string(english_word));
+  }
+  return *translation;
+}
+
+std::ostream &operator<<(std::ostream &out_stream,
+                         const FrozenDictionary &dict) {
+  dict.PrintHelper(out_stream, 1);
+  return out_stream;
+}
+
+void FrozenDictionary::AlignedDeleter::operator()(uint64_t *memory) const {
+  ::operator delete(memory, std::align_val_t(kCacheLineSize));
+}
+
+void FrozenDictionary::FillHelper(Dictionary::const_iterator &it,
+                                  size_t index) {
+  if (index > size_)
+    return;
+  FillHelper(it, 2 * index);
+  prefixes_[index] = utils::PackPrefix(it->first);
+  keys_[index] = it->first;
+  values_[index] = it->second;
+  ++it;
+  FillHelper(it, 2 * index + 1);
+}
+
+size_t
+FrozenDictionary::LowerBoundIndex(std::string_view english_word) const {
+  uint64_t prefix = utils::PackPrefix(english_word);
+  const uint64_t *prefixes = prefixes_.get();
+  size_t index = 1;
+  while (index <= size_) {
+#if defined(__GNUC__)
+    __builtin_prefetch(prefixes + std::min(index * kSlotsPerLine, size_));
+#endif
+    // Full strings are compared only when packed prefixes are equal
+    bool less = prefixes[index] < prefix ||
+                (prefixes[index] == prefix && keys_[index] < english_word);
+    index = 2 * index + less;
+  }
+  // Climb up over right turns: the answer is where the last left turn was
+  while (index & 1)
+    index >>= 1;
+  return index >> 1;
+}
+
+void FrozenDictionary::PrintHelper(std::ostream &out_stream,
+                                   size_t index) const {
+  if (index > size_)
+    return;
+  PrintHelper(out_stream, 2 * index);
+  out_stream << keys_[index] << ":" << values_[index] << "\n";
+  PrintHelper(out_stream, 2 * index + 1);
+}
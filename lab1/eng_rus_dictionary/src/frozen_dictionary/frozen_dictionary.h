@@ -0,0 +1,140 @@
+/**
+ * @file frozen_dictionary.h
+ * @brief Read-only English-Russian dictionary in cache-friendly layout
+ * @author Dmitry Burbas
+ * @date 10/11/2025
+ */
+#ifndef FROZEN_DICTIONARY_H
+#define FROZEN_DICTIONARY_H
+
+#include "../dictionary/dictionary.h"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Immutable snapshot of a Dictionary optimized for lookups.
+ *
+ * Words are stored in Eytzinger (breadth-first) order of an implicit
+ * complete binary search tree, so the first levels of every search share
+ * the same few cache lines. Each slot also keeps the first eight bytes of
+ * its word packed into an integer: the descent compares these integers and
+ * touches the full string only on a tie. The descent is branch-light:
+ * each level turns left or right by an index update, only a tie of
+ * prefixes branches to a string comparison. It prefetches the cache line
+ * holding the slots three levels below.
+ * The snapshot is movable but not copyable.
+ *
+ * @code
+ * Dictionary dict;
+ * dict += "hello:привет";
+ * FrozenDictionary frozen(dict);
+ * std::cout << frozen["hello"]; // Outputs: привет
+ * @endcode
+ */
+class FrozenDictionary {
+public:
+  /**
+   * @brief Default constructor. Creates an empty dictionary.
+   */
+  FrozenDictionary() = default;
+
+  /**
+   * @brief Builds snapshot of a dictionary in O(n).
+   * @param dictionary Dictionary to copy word pairs from
+   */
+  explicit FrozenDictionary(const Dictionary &dictionary);
+
+  /**
+   * @brief Looks up translation of a word.
+   * @param english_word Word to look up
+   * @return Pointer to Russian translation, nullptr if word is not present
+   */
+  const std::string *Find(std::string_view english_word) const;
+
+  /**
+   * @brief Checks if the dictionary contains a word.
+   * @param english_word Word to look up
+   * @return true if word is present
+   */
+  bool Contains(std::string_view english_word) const {
+    return Find(english_word) != nullptr;
+  }
+
+  /**
+   * @brief Accesses translation of an English word.
+   * @param english_word English word to look up
+   * @return Const reference to Russian translation
+   * @throw std::invalid\_argument if word is not valid English
+   * @throw std::out\_of\_range if word not found
+   */
+  const std::string &operator[](std::string_view english_word) const;
+
+  /**
+   * @brief Returns the number of word pairs in the dictionary.
+   * @return Size of dictionary
+   */
+  size_t GetSize() const { return size_; }
+
+  /**
+   * @brief Checks if dictionary is empty.
+   * @return true if dictionary contains no entries
+   */
+  bool IsEmpty() const { return size_ == 0; }
+
+  /**
+   * @brief Output stream operator. Prints all word pairs in format
+   * "english:russian" in alphabetical order.
+   * @param out_stream Output stream
+   * @param dict Dictionary to output
+   * @return Reference to output stream
+   */
+  friend std::ostream &operator<<(std::ostream &out_stream,
+                                  const FrozenDictionary &dict);
+
+private:
+  /**
+   * @brief Deleter for cache-line aligned prefix array.
+   */
+  struct AlignedDeleter {
+    void operator()(uint64_t *memory) const;
+  };
+
+  static constexpr size_t kCacheLineSize = 64; ///< Bytes in cache line
+  /// Slots in one cache line, Eytzinger index k * kSlotsPerLine is the
+  /// first of k's descendants three levels below
+  static constexpr size_t kSlotsPerLine = kCacheLineSize / sizeof(uint64_t);
+
+  size_t size_ = 0; ///< Number of word pairs
+  std::unique_ptr<uint64_t[], AlignedDeleter>
+      prefixes_;                    ///< Packed word prefixes, 1-indexed
+  std::vector<std::string> keys_;   ///< English words, 1-indexed
+  std::vector<std::string> values_; ///< Russian translations, 1-indexed
+
+  /**
+   * @brief Recursively fills slots in Eytzinger order from sorted pairs.
+   * @param it Iterator to the next pair in alphabetical order
+   * @param index Eytzinger index of the slot to fill
+   */
+  void FillHelper(Dictionary::const_iterator &it, size_t index);
+
+  /**
+   * @brief Eytzinger index of the first word not less than english_word.
+   * @param english_word Word to search for
+   * @return Slot index, 0 if all words are less than english_word
+   */
+  size_t LowerBoundIndex(std::string_view english_word) const;
+
+  /**
+   * @brief Recursively prints slots in alphabetical order.
+   * @param out_stream Output stream
+   * @param index Eytzinger index of subtree root
+   */
+  void PrintHelper(std::ostream &out_stream, size_t index) const;
+};
+
+#endif // FROZEN_DICTIONARY_H
@@ -0,0 +1,318 @@
+/**
+ * @file hash_index.hpp
+ * @brief Open addressing hash index over elements stored elsewhere
+ * @author Dmitry Burbas
+ * @date 19/11/2025
+ */
+
+#ifndef HASH_INDEX_HPP
+#define HASH_INDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <utility>
+
+/**
+ * @brief Hash table of pointers to key-value pairs owned by a container.
+ *
+ * The index doesn't own elements, it maps keys to elements of a node-based
+ * container whose elements never move, e.g. BinarySearchTree. Exact
+ * lookups take O(1) on average instead of O(log n) comparisons of
+ * strings.
+ *
+ * Slots are probed linearly and hold the precomputed hash next to the
+ * element pointer, so that probing compares keys only on equal hashes and
+ * rehashing never calls the hash function. Erase shifts following slots
+ * back instead of leaving tombstones. The table is at most 3/4 full and
+ * its memory comes from a std::pmr::memory\_resource.
+ *
+ * @tparam Element Element type with key in the member first
+ * @tparam Key Type to which keys are converted for hashing and comparison
+ * @tparam Hash Hash function of Key
+ */
+template <typename Element, typename Key = std::string_view,
+          typename Hash = std::hash<Key>>
+class HashIndex {
+public:
+  /**
+   * @brief Creates an empty index without a table.
+   * @param resource Source of the table memory, must outlive the index
+   */
+  explicit HashIndex(
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : resource_(resource) {}
+
+  /**
+   * @brief Copying is forbidden, elements of the copy live elsewhere.
+   */
+  HashIndex(const HashIndex &) = delete;
+  HashIndex &operator=(const HashIndex &) = delete;
+
+  /**
+   * @brief Move constructor. Takes the table of another index in O(1).
+   * @param other Index to move from, left empty
+   */
+  HashIndex(HashIndex &&other) noexcept : resource_(other.resource_) {
+    Swap(other);
+  }
+
+  /**
+   * @brief Move assignment operator. Takes the table and the resource.
+   * @param other Index to move from, left empty
+   * @return Reference to this index
+   */
+  HashIndex &operator=(HashIndex &&other) noexcept {
+    if (this != &other) {
+      Release();
+      Swap(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Destructor. Returns the table to the memory resource.
+   */
+  ~HashIndex() { Release(); }
+
+  /**
+   * @brief Exchanges tables and memory resources of two indexes in O(1).
+   * @param other Index to swap with
+   */
+  void Swap(HashIndex &other) noexcept {
+    std::swap(hash_, other.hash_);
+    std::swap(resource_, other.resource_);
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+  }
+
+  /**
+   * @brief Finds the element with given key.
+   * @param key Key to search for
+   * @return Pointer to the element, nullptr if key is absent
+   */
+  Element *Find(const Key &key) const {
+    if (size_ == 0)
+      return nullptr;
+    size_t hash = hash_(key);
+    for (size_t index = hash & Mask();; index = (index + 1) & Mask()) {
+      const Slot &slot = slots_[index];
+      if (!slot.element)
+        return nullptr;
+      if (slot.hash == hash && Key(slot.element->first) == key)
+        return slot.element;
+    }
+  }
+
+  /**
+   * @brief Finds elements of many keys, overlapping cache misses.
+   *
+   * Keys are processed in groups of kBatchWidth in three passes: hash
+   * every key and prefetch its home slot, find the first slot with equal
+   * hash and prefetch its element, then compare keys and finish probing.
+   * Each pass touches memory requested by the previous one.
+   *
+   * @param keys Keys to find
+   * @param count Number of keys
+   * @param results Output array of count element pointers, nullptr for
+   * absent keys
+   */
+  void FindBatch(const Key *keys, size_t count, Element **results) const {
+    if (size_ == 0) {
+      for (size_t index = 0; index < count; ++index)
+        results[index] = nullptr;
+      return;
+    }
+    size_t hashes[kBatchWidth];
+    size_t slots[kBatchWidth];
+    for (size_t first = 0; first < count; first += kBatchWidth) {
+      size_t width = std::min(kBatchWidth, count - first);
+      for (size_t query = 0; query < width; ++query) {
+        hashes[query] = hash_(keys[first + query]);
+        Prefetch(slots_ + (hashes[query] & Mask()));
+      }
+      for (size_t query = 0; query < width; ++query) {
+        size_t index = hashes[query] & Mask();
+        while (slots_[index].element && slots_[index].hash != hashes[query])
+          index = (index + 1) & Mask();
+        slots[query] = index;
+        Prefetch(slots_[index].element);
+      }
+      for (size_t query = 0; query < width; ++query) {
+        const Key &key = keys[first + query];
+        Element *found = nullptr;
+        for (size_t index = slots[query]; slots_[index].element;
+             index = (index + 1) & Mask()) {
+          const Slot &slot = slots_[index];
+          if (slot.hash == hashes[query] && Key(slot.element->first) == key) {
+            found = slot.element;
+            break;
+          }
+        }
+        results[first + query] = found;
+      }
+    }
+  }
+
+  /**
+   * @brief Adds an element whose key is not in the index yet.
+   * @param element Element to index, must stay at its address until erased
+   */
+  void Insert(Element *element) {
+    if ((size_ + 1) * 4 > capacity_ * 3)
+      Rehash(capacity_ ? capacity_ * 2 : kMinCapacity);
+    Place(Slot{hash_(Key(element->first)), element});
+    ++size_;
+  }
+
+  /**
+   * @brief Removes the element with given key from the index.
+   * @param key Key to remove
+   * @return true if the key was indexed
+   */
+  bool Erase(const Key &key) {
+    if (size_ == 0)
+      return false;
+    size_t hash = hash_(key);
+    size_t index = hash & Mask();
+    while (true) {
+      const Slot &slot = slots_[index];
+      if (!slot.element)
+        return false;
+      if (slot.hash == hash && Key(slot.element->first) == key)
+        break;
+      index = (index + 1) & Mask();
+    }
+    // Shift back every following slot whose home isn't cyclically in
+    // (index, next], so that probe sequences stay unbroken
+    size_t next = index;
+    while (true) {
+      next = (next + 1) & Mask();
+      if (!slots_[next].element)
+        break;
+      size_t home = slots_[next].hash & Mask();
+      if (((next - home) & Mask()) >= ((next - index) & Mask())) {
+        slots_[index] = slots_[next];
+        index = next;
+      }
+    }
+    slots_[index] = Slot{};
+    --size_;
+    return true;
+  }
+
+  /**
+   * @brief Removes all elements, keeping the table.
+   */
+  void Clear() {
+    for (size_t index = 0; index < capacity_; ++index)
+      slots_[index] = Slot{};
+    size_ = 0;
+  }
+
+  /**
+   * @brief Ensures that count elements fit without rehashing.
+   * @param count Number of elements
+   */
+  void Reserve(size_t count) {
+    size_t capacity = capacity_ ? capacity_ : kMinCapacity;
+    while (count * 4 > capacity * 3)
+      capacity *= 2;
+    if (capacity != capacity_)
+      Rehash(capacity);
+  }
+
+  /**
+   * @brief Returns number of indexed elements.
+   */
+  size_t GetSize() const { return size_; }
+
+  /**
+   * @brief Returns memory taken by the table in bytes.
+   */
+  size_t GetMemoryUsage() const { return capacity_ * sizeof(Slot); }
+
+private:
+  /**
+   * @brief Cell of the table, empty if element is nullptr.
+   */
+  struct Slot {
+    size_t hash = 0;            ///< Hash of the element's key
+    Element *element = nullptr; ///< Indexed element
+  };
+
+  static constexpr size_t kMinCapacity = 16; ///< Size of the first table
+  static constexpr size_t kBatchWidth = 16;  ///< Keys per FindBatch group
+
+  Hash hash_;                           ///< Hash function of keys
+  std::pmr::memory_resource *resource_; ///< Source of the table
+  Slot *slots_ = nullptr;               ///< Table of capacity\_ slots
+  size_t capacity_ = 0;                 ///< Number of slots, power of two
+  size_t size_ = 0;                     ///< Number of occupied slots
+
+  /**
+   * @brief Returns the mask that maps hashes to slot indexes.
+   */
+  size_t Mask() const { return capacity_ - 1; }
+
+  /**
+   * @brief Asks the processor to start loading memory into cache.
+   * @param address Address that will be read soon, may be nullptr
+   */
+  static void Prefetch(const void *address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+  }
+
+  /**
+   * @brief Puts a slot into the first free cell of its probe sequence.
+   * @param slot Slot with a key absent from the table
+   */
+  void Place(const Slot &slot) {
+    size_t index = slot.hash & Mask();
+    while (slots_[index].element)
+      index = (index + 1) & Mask();
+    slots_[index] = slot;
+  }
+
+  /**
+   * @brief Moves all slots to a new table using stored hashes.
+   * @param capacity Number of slots in the new table, power of two
+   */
+  void Rehash(size_t capacity) {
+    Slot *old_slots = slots_;
+    size_t old_capacity = capacity_;
+    slots_ = static_cast<Slot *>(
+        resource_->allocate(capacity * sizeof(Slot), alignof(Slot)));
+    capacity_ = capacity;
+    for (size_t index = 0; index < capacity_; ++index)
+      new (slots_ + index) Slot{};
+    for (size_t index = 0; index < old_capacity; ++index) {
+      if (old_slots[index].element)
+        Place(old_slots[index]);
+    }
+    if (old_slots)
+      resource_->deallocate(old_slots, old_capacity * sizeof(Slot),
+                            alignof(Slot));
+  }
+
+  /**
+   * @brief Returns the table to the memory resource.
+   */
+  void Release() {
+    if (slots_)
+      resource_->deallocate(slots_, capacity_ * sizeof(Slot), alignof(Slot));
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+  }
+};
+
+#endif // HASH_INDEX_HPP
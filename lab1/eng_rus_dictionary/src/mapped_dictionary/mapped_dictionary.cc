@@ -0,0 +1,78 @@
+/**
+ * @file mapped_dictionary.cc
+ * @brief Implementation of MappedDictionary class methods
+ * @author Dmitry Burbas
+ * @date 20/11/2025
+ */
+
+#include "../dictionary_utils/dictionary_utils.h"
+#include "mapped_dictionary.h"
+#include <stdexcept>
+
+MappedDictionary &MappedDictionary::operator+=(
+    const std::pair<std::string, std::string> &word_pair) {
+  AddWordPair(word_pair.first, word_pair.second);
+  return *this;
+}
+MappedDictionary &MappedDictionary::operator+=(const std::string &word_pair) {
+  std::string english_word, russian_word;
+  utils::ParseWordPair(english_word, russian_word, word_pair);
+  AddWordPair(english_word, russian_word);
+  return *this;
+}
+MappedDictionary &MappedDictionary::operator+=(const char *word_pair) {
+  return *this += std::string(word_pair);
+}
+
+MappedDictionary &MappedDictionary::operator-=(std::string_view english_word) {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: word must be english");
+  }
+  if (!tree_.Erase(english_word)) {
+    throw std::out_of_range("Word not found: " + std::string(english_word));
+  }
+  return *this;
+}
+
+std::string_view
+MappedDictionary::operator[](std::string_view english_word) const {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: word must be english");
+  }
+  std::optional<std::string_view> translation = tree_.Find(english_word);
+  if (!translation) {
+    throw std::out_of_range("Word not found: " + std::string(english_word));
+  }
+  return *translation;
+}
+
+void MappedDictionary::Assign(const Dictionary &dictionary) {
+  tree_.Clear();
+  for (const auto &word_pair : dictionary)
+    tree_.Insert(word_pair.first, word_pair.second);
+}
+
+std::ostream &operator<<(std::ostream &out_stream,
+                         const MappedDictionary &dict) {
+  dict.tree_.InOrderTraversal(
+      [&out_stream](std::string_view english_word,
+                    std::string_view russian_word) {
+        out_stream << english_word << ":" << russian_word << "\n";
+      });
+  return out_stream;
+}
+
+void MappedDictionary::AddWordPair(std::string_view english_word,
+                                   std::string_view russian_word) {
+  if (!utils::IsEnglishWord(english_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: first word must be english");
+  }
+  if (!utils::IsRussianWord(russian_word)) {
+    throw std::invalid_argument(
+        "Invalid argument format: second word must be russian");
+  }
+  tree_.Insert(english_word, russian_word);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file mapped_dictionary.h
+ * @brief English-Russian dictionary stored in a memory-mapped file
+ * @author Dmitry Burbas
+ * @date 20/11/2025
+ */
+#ifndef MAPPED_DICTIONARY_H
+#define MAPPED_DICTIONARY_H
+
+#include "../dictionary/dictionary.h"
+#include "../mapped_tree/mapped_tree.h"
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * @brief Dictionary that lives in a file and opens without loading.
+ *
+ * Word pairs are kept in a MappedTree, so a service that restarts often
+ * opens its dictionary in constant time instead of parsing a text file and
+ * building a tree. Adding and removing words changes the file in place;
+ * Sync makes the changes durable. Translations are returned as views into
+ * the file, valid until the next modification.
+ *
+ * @code
+ * MappedDictionary dict("dictionary.tree");
+ * if (dict.IsEmpty()) {
+ *   Dictionary text;
+ *   text.LoadFromFile("dictionary.txt");
+ *   dict.Assign(text);
+ * }
+ * dict += "hello:привет";
+ * dict.Sync();
+ * std::cout << dict["hello"]; // Outputs: привет
+ * @endcode
+ */
+class MappedDictionary {
+public:
+  /**
+   * @brief Opens a dictionary file, creating an empty one if it is absent.
+   * @param path Path of the file
+   * @throw std::system\_error if the file can't be opened or mapped
+   * @throw std::runtime\_error if the file is not a dictionary file
+   */
+  explicit MappedDictionary(const std::string &path) : tree_(path) {}
+
+  /**
+   * @brief Adds a word pair, replacing an existing translation.
+   * @param word_pair Pair of English word and Russian translation
+   * @return Reference to this dictionary
+   * @throw std::invalid\_argument if word format is invalid
+   */
+  MappedDictionary &
+  operator+=(const std::pair<std::string, std::string> &word_pair);
+
+  /**
+   * @brief Adds a word pair given as "english:russian".
+   * @param word_pair String with the pair
+   * @return Reference to this dictionary
+   * @throw std::invalid\_argument if the format is invalid
+   */
+  MappedDictionary &operator+=(const std::string &word_pair);
+
+  /**
+   * @brief Adds a word pair given as "english:russian" C-string.
+   * @param word_pair C-string with the pair
+   * @return Reference to this dictionary
+   * @throw std::invalid\_argument if the format is invalid
+   */
+  MappedDictionary &operator+=(const char *word_pair);
+
+  /**
+   * @brief Removes an English word with its translation.
+   * @param english_word Word to remove
+   * @return Reference to this dictionary
+   * @throw std::invalid\_argument if word is not valid English
+   * @throw std::out\_of\_range if word not found
+   */
+  MappedDictionary &operator-=(std::string_view english_word);
+
+  /**
+   * @brief Accesses translation of an English word.
+   *
+   * The view points into the mapped file. Any modification (+=, -=,
+   * Assign, Clear) may remap or overwrite it, so the view must be copied
+   * into a string if it is needed afterwards.
+   *
+   * @param english_word English word to look up
+   * @return View of Russian translation in the file, valid until the
+   * next modification
+   * @throw std::invalid\_argument if word is not valid English
+   * @throw std::out\_of\_range if word not found
+   */
+  std::string_view operator[](std::string_view english_word) const;
+
+  /**
+   * @brief Looks up translation of a word without throwing.
+   * @param english_word Word to look up
+   * @return View of Russian translation, valid until the next
+   * modification as for operator[], std::nullopt if word is absent
+   */
+  std::optional<std::string_view> Find(std::string_view english_word) const {
+    return tree_.Find(english_word);
+  }
+
+  /**
+   * @brief Checks if the dictionary contains a word.
+   * @param english_word Word to look up
+   * @return true if word is present
+   */
+  bool Contains(std::string_view english_word) const {
+    return tree_.Contains(english_word);
+  }
+
+  /**
+   * @brief Replaces all word pairs with those of a dictionary.
+   * @param dictionary Dictionary to copy word pairs from
+   */
+  void Assign(const Dictionary &dictionary);
+
+  /**
+   * @brief Removes all entries from the dictionary.
+   */
+  void Clear() { tree_.Clear(); }
+
+  /**
+   * @brief Returns the number of word pairs in the dictionary.
+   */
+  size_t GetSize() const { return tree_.GetSize(); }
+
+  /**
+   * @brief Checks if dictionary is empty.
+   */
+  bool IsEmpty() const { return tree_.IsEmpty(); }
+
+  /**
+   * @brief Writes all changes to the disk and waits for it.
+   * @throw std::system\_error if writing fails
+   */
+  void Sync() { tree_.Sync(); }
+
+  /**
+   * @brief Output stream operator. Prints all word pairs in format
+   * "english:russian" in alphabetical order.
+   * @param out_stream Output stream
+   * @param dict Dictionary to output
+   * @return Reference to output stream
+   */
+  friend std::ostream &operator<<(std::ostream &out_stream,
+                                  const MappedDictionary &dict);
+
+private:
+  MappedTree tree_; ///< Word pairs in the mapped file
+
+  /**
+   * @brief Validates words and inserts them.
+   * @param english_word English word
+   * @param russian_word Its Russian translation
+   * @throw std::invalid\_argument if word format is invalid
+   */
+  void AddWordPair(std::string_view english_word,
+                   std::string_view russian_word);
+};
+
+#endif // MAPPED_DICTIONARY_H
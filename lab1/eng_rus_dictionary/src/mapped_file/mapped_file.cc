@@ -0,0 +1,110 @@
+/**
+ * @file mapped_file.cc
+ * @brief Implementation of MappedFile class methods
+ * @author Dmitry Burbas
+ * @date 22/11/2025
+ */
+
+#include "mapped_file.h"
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#if !defined(MAPPED_FILE_NO_MMAP) && __has_include(<sys/mman.h>)
+#define MAPPED_FILE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define MAPPED_FILE_USE_MMAP 0
+#include <cstdio>
+#include <filesystem>
+#endif
+
+#if MAPPED_FILE_USE_MMAP
+
+MappedFile::MappedFile(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(),
+                            "Cannot open " + path);
+  struct stat status;
+  if (::fstat(fd, &status) != 0) {
+    int error = errno;
+    ::close(fd);
+    throw std::system_error(error, std::generic_category(),
+                            "Cannot stat " + path);
+  }
+  size_ = static_cast<size_t>(status.st_size);
+  // An empty file can't be mapped, its contents are an empty view
+  if (size_ > 0) {
+    void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(),
+                              "Cannot map " + path);
+    }
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char *>(data);
+  }
+  // The mapping stays valid after the descriptor is closed
+  ::close(fd);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path) {
+  std::error_code error;
+  size_t size = static_cast<size_t>(std::filesystem::file_size(path, error));
+  if (error)
+    throw std::system_error(error, "Cannot open " + path);
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  if (!file)
+    throw std::system_error(errno, std::generic_category(),
+                            "Cannot open " + path);
+  // Without mmap the whole file is read with one call into the buffer
+  buffer_.resize(size);
+  size_t read = std::fread(buffer_.data(), 1, size, file);
+  bool failed = std::ferror(file) != 0;
+  std::fclose(file);
+  if (failed) {
+    buffer_.clear();
+    throw std::system_error(std::make_error_code(std::errc::io_error),
+                            "Cannot read " + path);
+  }
+  // The file may have shrunk since its size was taken
+  buffer_.resize(read);
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      buffer_(std::move(other.buffer_)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    Close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    buffer_ = std::move(other.buffer_);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { Close(); }
+
+void MappedFile::Close() noexcept {
+#if MAPPED_FILE_USE_MMAP
+  if (data_)
+    ::munmap(const_cast<char *>(data_), size_);
+#endif
+  buffer_ = std::vector<char>();
+  data_ = nullptr;
+  size_ = 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only view of a whole file mapped into memory
+ * @author Dmitry Burbas
+ * @date 22/11/2025
+ */
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Contents of a file mapped into memory for reading.
+ *
+ * The file is mapped with mmap as a whole, so its bytes are read straight
+ * from the page cache without copying them into stream buffers. The
+ * operating system is told that the mapping is read sequentially and
+ * reads ahead. Where mmap is not available, or if MAPPED\_FILE\_NO\_MMAP
+ * is defined, the file is read into a buffer in one call instead, so
+ * users of the contents work on every system.
+ *
+ * @code
+ * MappedFile file("words.txt");
+ * std::string_view text = file.GetContents();
+ * @endcode
+ */
+class MappedFile {
+public:
+  /**
+   * @brief Maps a file for reading.
+   * @param path Path of the file
+   * @throw std::system\_error if the file can't be opened, mapped or read
+   */
+  explicit MappedFile(const std::string &path);
+
+  /**
+   * @brief Copying is forbidden, a mapping belongs to one object.
+   */
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * @brief Move constructor. Takes the mapping of another file.
+   * @param other File to move from, left empty
+   */
+  MappedFile(MappedFile &&other) noexcept;
+
+  /**
+   * @brief Move assignment operator. Unmaps own file first.
+   * @param other File to move from, left empty
+   * @return Reference to this file
+   */
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  /**
+   * @brief Destructor. Unmaps the file.
+   */
+  ~MappedFile();
+
+  /**
+   * @brief Returns the bytes of the file, valid while the object lives.
+   */
+  std::string_view GetContents() const { return {data_, size_}; }
+
+  /**
+   * @brief Returns the size of the file in bytes.
+   */
+  size_t GetSize() const { return size_; }
+
+private:
+  const char *data_ = nullptr; ///< Start of the mapping or the buffer
+  size_t size_ = 0;            ///< Size of the file and of the mapping
+  std::vector<char> buffer_;   ///< Contents if the file is not mapped
+
+  /**
+   * @brief Unmaps the file or frees the buffer.
+   */
+  void Close() noexcept;
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,425 @@
+/**
+ * @file mapped_tree.cc
+ * @brief Implementation of MappedTree class methods
+ * @author Dmitry Burbas
+ * @date 20/11/2025
+ */
+
+#include "mapped_tree.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+
+constexpr char kMagic[8] = {'E', 'R', 'D', 'T', 'R', 'E', 'E', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kSizeClasses = 48;          ///< Data blocks up to 2^51 bytes
+constexpr size_t kMinBlockSize = 16;         ///< Size of data class 0
+constexpr size_t kInitialFileSize = 1 << 16; ///< Size of a new file
+
+/**
+ * @brief Throws std::system\_error for the current errno.
+ * @param what Failed operation
+ */
+[[noreturn]] void ThrowSystemError(const std::string &what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+/**
+ * @brief First bytes of the file, all offsets count from its start.
+ */
+struct MappedTree::Header {
+  char magic[8];                      ///< kMagic
+  uint32_t version;                   ///< kVersion
+  uint32_t node_size;                 ///< sizeof(Node) of the writer
+  uint64_t root;                      ///< Offset of the root, 0 if empty
+  uint64_t size;                      ///< Number of nodes
+  uint64_t end;                       ///< First never allocated byte
+  uint64_t free_nodes;                ///< Free list of nodes
+  uint64_t free_blocks[kSizeClasses]; ///< Free lists of data blocks
+};
+
+/**
+ * @brief Tree node, key and value bytes lie in a separate data block.
+ */
+struct MappedTree::Node {
+  uint64_t left;       ///< Offset of the left child, 0 if none
+  uint64_t right;      ///< Offset of the right child, 0 if none
+  uint64_t data;       ///< Offset of key bytes followed by value bytes
+  uint32_t key_size;   ///< Length of the key
+  uint32_t value_size; ///< Length of the value
+  int32_t height;      ///< Height of the subtree
+};
+
+MappedTree::MappedTree(const std::string &path) : path_(path) {
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0)
+    ThrowSystemError("Cannot open " + path);
+  try {
+    struct stat status;
+    if (::fstat(fd_, &status) != 0)
+      ThrowSystemError("Cannot stat " + path);
+    bool is_new = status.st_size == 0;
+    if (is_new && ::ftruncate(fd_, kInitialFileSize) != 0)
+      ThrowSystemError("Cannot resize " + path);
+    capacity_ =
+        is_new ? kInitialFileSize : static_cast<size_t>(status.st_size);
+    if (capacity_ < sizeof(Header))
+      throw std::runtime_error("Not a tree file: " + path);
+    Map();
+    if (is_new) {
+      Format();
+    } else {
+      const Header *header = GetHeader();
+      if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+          header->version != kVersion || header->node_size != sizeof(Node) ||
+          header->end > capacity_) {
+        throw std::runtime_error("Not a tree file: " + path);
+      }
+    }
+  } catch (...) {
+    Close();
+    throw;
+  }
+}
+
+MappedTree::MappedTree(MappedTree &&other) noexcept
+    : path_(std::move(other.path_)), fd_(std::exchange(other.fd_, -1)),
+      base_(std::exchange(other.base_, nullptr)),
+      capacity_(std::exchange(other.capacity_, 0)) {}
+
+MappedTree &MappedTree::operator=(MappedTree &&other) noexcept {
+  if (this != &other) {
+    Close();
+    path_ = std::move(other.path_);
+    fd_ = std::exchange(other.fd_, -1);
+    base_ = std::exchange(other.base_, nullptr);
+    capacity_ = std::exchange(other.capacity_, 0);
+  }
+  return *this;
+}
+
+MappedTree::~MappedTree() { Close(); }
+
+bool MappedTree::Insert(std::string_view key, std::string_view value) {
+  if (key.size() > std::numeric_limits<uint32_t>::max() ||
+      value.size() > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Key or value too long for MappedTree");
+  }
+  // Growing remaps the file, so views into it are copied first
+  std::string key_copy;
+  std::string value_copy;
+  if (IsMapped(key))
+    key = key_copy.assign(key);
+  if (IsMapped(value))
+    value = value_copy.assign(value);
+  // Nothing below may remap the file, nodes are accessed by pointers
+  Reserve(key.size() + value.size());
+  bool inserted = false;
+  GetHeader()->root = InsertHelper(Root(), key, value, inserted);
+  if (inserted)
+    ++GetHeader()->size;
+  return inserted;
+}
+
+bool MappedTree::Erase(std::string_view key) {
+  bool erased = false;
+  GetHeader()->root = EraseHelper(Root(), key, erased);
+  if (erased)
+    --GetHeader()->size;
+  return erased;
+}
+
+std::optional<std::string_view> MappedTree::Find(std::string_view key) const {
+  uint64_t node = Root();
+  while (node) {
+    int order = key.compare(KeyOf(node));
+    if (order == 0)
+      return ValueOf(node);
+    node = order < 0 ? LeftOf(node) : RightOf(node);
+  }
+  return std::nullopt;
+}
+
+void MappedTree::Clear() { Format(); }
+
+size_t MappedTree::GetSize() const { return GetHeader()->size; }
+
+size_t MappedTree::GetHeight() const {
+  return static_cast<size_t>(HeightOf(Root()));
+}
+
+void MappedTree::Sync() {
+  if (::msync(base_, capacity_, MS_SYNC) != 0)
+    ThrowSystemError("Cannot sync " + path_);
+  // Growth changed the file size, which msync doesn't write
+  if (::fsync(fd_) != 0)
+    ThrowSystemError("Cannot sync " + path_);
+}
+
+void MappedTree::Close() noexcept {
+  if (base_)
+    ::munmap(base_, capacity_);
+  if (fd_ >= 0)
+    ::close(fd_);
+  base_ = nullptr;
+  fd_ = -1;
+  capacity_ = 0;
+}
+
+void MappedTree::Map() {
+  void *mapping = ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED)
+    ThrowSystemError("Cannot map " + path_);
+  base_ = static_cast<std::byte *>(mapping);
+}
+
+void MappedTree::Format() {
+  Header *header = GetHeader();
+  std::memset(header, 0, sizeof(Header));
+  std::memcpy(header->magic, kMagic, sizeof(kMagic));
+  header->version = kVersion;
+  header->node_size = sizeof(Node);
+  // Blocks start on a cache line after the header
+  header->end = (sizeof(Header) + 63) / 64 * 64;
+}
+
+void MappedTree::Grow(size_t bytes) {
+  size_t end = GetHeader()->end;
+  size_t capacity = capacity_;
+  while (capacity - end < bytes)
+    capacity *= 2;
+  if (::ftruncate(fd_, static_cast<off_t>(capacity)) != 0)
+    ThrowSystemError("Cannot resize " + path_);
+  // Map the larger file before unmapping, a failure leaves the old mapping
+  void *mapping = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED)
+    ThrowSystemError("Cannot map " + path_);
+  ::munmap(base_, capacity_);
+  base_ = static_cast<std::byte *>(mapping);
+  capacity_ = capacity;
+}
+
+void MappedTree::Reserve(size_t data_bytes) {
+  size_t needed = sizeof(Node) + (kMinBlockSize << SizeClass(data_bytes));
+  if (capacity_ - GetHeader()->end < needed)
+    Grow(needed);
+}
+
+uint64_t MappedTree::AllocateNode() {
+  return Pop(GetHeader()->free_nodes, sizeof(Node));
+}
+
+void MappedTree::FreeNode(uint64_t node) {
+  Push(GetHeader()->free_nodes, node);
+}
+
+uint64_t MappedTree::AllocateData(size_t bytes) {
+  size_t size_class = SizeClass(bytes);
+  return Pop(GetHeader()->free_blocks[size_class], kMinBlockSize << size_class);
+}
+
+void MappedTree::FreeData(uint64_t offset, size_t bytes) {
+  Push(GetHeader()->free_blocks[SizeClass(bytes)], offset);
+}
+
+uint64_t MappedTree::Pop(uint64_t &free_list, size_t block_size) {
+  if (uint64_t block = free_list) {
+    std::memcpy(&free_list, base_ + block, sizeof(uint64_t));
+    return block;
+  }
+  Header *header = GetHeader();
+  uint64_t block = header->end;
+  header->end += block_size;
+  return block;
+}
+
+void MappedTree::Push(uint64_t &free_list, uint64_t block) {
+  std::memcpy(base_ + block, &free_list, sizeof(uint64_t));
+  free_list = block;
+}
+
+size_t MappedTree::SizeClass(size_t bytes) {
+  size_t size_class = 0;
+  while ((kMinBlockSize << size_class) < bytes)
+    ++size_class;
+  return size_class;
+}
+
+MappedTree::Header *MappedTree::GetHeader() const {
+  return reinterpret_cast<Header *>(base_);
+}
+
+MappedTree::Node *MappedTree::At(uint64_t offset) const {
+  return reinterpret_cast<Node *>(base_ + offset);
+}
+
+uint64_t MappedTree::Root() const { return GetHeader()->root; }
+
+uint64_t MappedTree::LeftOf(uint64_t node) const { return At(node)->left; }
+
+uint64_t MappedTree::RightOf(uint64_t node) const { return At(node)->right; }
+
+std::string_view MappedTree::KeyOf(uint64_t node) const {
+  const Node *at = At(node);
+  return {reinterpret_cast<const char *>(base_ + at->data), at->key_size};
+}
+
+std::string_view MappedTree::ValueOf(uint64_t node) const {
+  const Node *at = At(node);
+  return {reinterpret_cast<const char *>(base_ + at->data + at->key_size),
+          at->value_size};
+}
+
+bool MappedTree::IsMapped(std::string_view bytes) const {
+  std::less<const void *> less;
+  return !less(bytes.data(), base_) && less(bytes.data(), base_ + capacity_);
+}
+
+uint64_t MappedTree::StoreData(std::string_view key, std::string_view value) {
+  uint64_t data = AllocateData(key.size() + value.size());
+  std::memcpy(base_ + data, key.data(), key.size());
+  std::memcpy(base_ + data + key.size(), value.data(), value.size());
+  return data;
+}
+
+uint64_t MappedTree::CreateNode(std::string_view key, std::string_view value) {
+  uint64_t data = StoreData(key, value);
+  uint64_t node = AllocateNode();
+  Node *at = At(node);
+  at->left = 0;
+  at->right = 0;
+  at->data = data;
+  at->key_size = static_cast<uint32_t>(key.size());
+  at->value_size = static_cast<uint32_t>(value.size());
+  at->height = 1;
+  return node;
+}
+
+void MappedTree::DestroyNode(uint64_t node) {
+  const Node *at = At(node);
+  FreeData(at->data, at->key_size + at->value_size);
+  FreeNode(node);
+}
+
+int32_t MappedTree::HeightOf(uint64_t node) const {
+  return node ? At(node)->height : 0;
+}
+
+void MappedTree::UpdateHeight(uint64_t node) {
+  Node *at = At(node);
+  at->height = 1 + std::max(HeightOf(at->left), HeightOf(at->right));
+}
+
+uint64_t MappedTree::RotateLeft(uint64_t node) {
+  uint64_t pivot = At(node)->right;
+  At(node)->right = At(pivot)->left;
+  At(pivot)->left = node;
+  UpdateHeight(node);
+  UpdateHeight(pivot);
+  return pivot;
+}
+
+uint64_t MappedTree::RotateRight(uint64_t node) {
+  uint64_t pivot = At(node)->left;
+  At(node)->left = At(pivot)->right;
+  At(pivot)->right = node;
+  UpdateHeight(node);
+  UpdateHeight(pivot);
+  return pivot;
+}
+
+uint64_t MappedTree::Balance(uint64_t node) {
+  UpdateHeight(node);
+  Node *at = At(node);
+  int32_t balance = HeightOf(at->left) - HeightOf(at->right);
+  if (balance > 1) {
+    const Node *child = At(at->left);
+    if (HeightOf(child->left) < HeightOf(child->right))
+      at->left = RotateLeft(at->left);
+    return RotateRight(node);
+  }
+  if (balance < -1) {
+    const Node *child = At(at->right);
+    if (HeightOf(child->right) < HeightOf(child->left))
+      at->right = RotateRight(at->right);
+    return RotateLeft(node);
+  }
+  return node;
+}
+
+uint64_t MappedTree::InsertHelper(uint64_t node, std::string_view key,
+                                  std::string_view value, bool &inserted) {
+  if (!node) {
+    inserted = true;
+    return CreateNode(key, value);
+  }
+  int order = key.compare(KeyOf(node));
+  if (order < 0) {
+    uint64_t left = InsertHelper(At(node)->left, key, value, inserted);
+    At(node)->left = left;
+  } else if (order > 0) {
+    uint64_t right = InsertHelper(At(node)->right, key, value, inserted);
+    At(node)->right = right;
+  } else {
+    // The old block is freed last, freeing writes a link into it and the
+    // same size class would hand it out again
+    uint64_t data = StoreData(key, value);
+    Node *at = At(node);
+    FreeData(at->data, at->key_size + at->value_size);
+    at->data = data;
+    at->value_size = static_cast<uint32_t>(value.size());
+    return node;
+  }
+  return inserted ? Balance(node) : node;
+}
+
+uint64_t MappedTree::EraseHelper(uint64_t node, std::string_view key,
+                                 bool &erased) {
+  if (!node)
+    return 0;
+  int order = key.compare(KeyOf(node));
+  if (order < 0) {
+    At(node)->left = EraseHelper(At(node)->left, key, erased);
+  } else if (order > 0) {
+    At(node)->right = EraseHelper(At(node)->right, key, erased);
+  } else {
+    erased = true;
+    Node *at = At(node);
+    uint64_t left = at->left;
+    uint64_t right = at->right;
+    DestroyNode(node);
+    if (!right)
+      return left;
+    uint64_t successor = 0;
+    uint64_t rest = DetachLeftmost(right, successor);
+    At(successor)->left = left;
+    At(successor)->right = rest;
+    return Balance(successor);
+  }
+  return erased ? Balance(node) : node;
+}
+
+uint64_t MappedTree::DetachLeftmost(uint64_t node, uint64_t &leftmost) {
+  Node *at = At(node);
+  if (!at->left) {
+    leftmost = node;
+    return at->right;
+  }
+  at->left = DetachLeftmost(at->left, leftmost);
+  return Balance(node);
+}
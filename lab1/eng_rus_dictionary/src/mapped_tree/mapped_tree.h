@@ -0,0 +1,393 @@
+/**
+ * @file mapped_tree.h
+ * @brief AVL tree of string pairs stored in a memory-mapped file
+ * @author Dmitry Burbas
+ * @date 20/11/2025
+ */
+#ifndef MAPPED_TREE_H
+#define MAPPED_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Persistent string-to-string AVL tree living in a file.
+ *
+ * The whole tree (nodes and bytes of keys and values) is kept in a file
+ * mapped into memory with mmap. Links are byte offsets from the start of
+ * the file rather than pointers, so the file can be mapped at any address:
+ * opening an existing file only maps it, nothing is parsed or rebuilt.
+ * Insert and Erase change the mapped structure in place; the operating
+ * system writes changed pages back on its own, Sync forces it.
+ *
+ * Space is taken from the end of the file, which grows twice when full,
+ * and freed blocks go to free lists of power-of-two size classes for
+ * reuse. Blocks are never merged, so a file with much erased data can be
+ * compacted by copying the tree into a new one.
+ *
+ * The file layout is native (byte order and alignment of the machine that
+ * created it). Only POSIX systems are supported. A tree must not be
+ * changed through two objects or processes at once.
+ *
+ * @code
+ * {
+ *   MappedTree tree("words.tree");
+ *   tree.Insert("hello", "привет");
+ *   tree.Sync();
+ * }
+ * MappedTree reopened("words.tree"); // instant, no parsing
+ * std::cout << *reopened.Find("hello"); // Outputs: привет
+ * @endcode
+ */
+class MappedTree {
+public:
+  /**
+   * @brief Opens a tree file, creating an empty tree if it doesn't exist.
+   * @param path Path of the file
+   * @throw std::system\_error if the file can't be opened or mapped
+   * @throw std::runtime\_error if the file is not a tree file
+   */
+  explicit MappedTree(const std::string &path);
+
+  /**
+   * @brief Copying is forbidden, a file is mapped by one object.
+   */
+  MappedTree(const MappedTree &) = delete;
+  MappedTree &operator=(const MappedTree &) = delete;
+
+  /**
+   * @brief Move constructor. Takes the mapping of another tree.
+   * @param other Tree to move from, left without a file
+   */
+  MappedTree(MappedTree &&other) noexcept;
+
+  /**
+   * @brief Move assignment operator. Closes own file first.
+   * @param other Tree to move from, left without a file
+   * @return Reference to this tree
+   */
+  MappedTree &operator=(MappedTree &&other) noexcept;
+
+  /**
+   * @brief Destructor. Unmaps and closes the file without syncing.
+   *
+   * Changed pages still reach the file, only the moment is up to the
+   * operating system.
+   */
+  ~MappedTree();
+
+  /**
+   * @brief Inserts a key or replaces the value of an existing one.
+   *
+   * Key and value may be views into this tree, e.g. returned by Find.
+   *
+   * @param key Key to insert
+   * @param value Value to store
+   * @return true if the key was new
+   * @throw std::system\_error if the file can't grow
+   */
+  bool Insert(std::string_view key, std::string_view value);
+
+  /**
+   * @brief Removes a key and frees its space for reuse.
+   * @param key Key to remove
+   * @return true if the key was present
+   */
+  bool Erase(std::string_view key);
+
+  /**
+   * @brief Searches for a key.
+   *
+   * The returned view points into the mapping and stays valid until the
+   * next Insert, Erase or Clear.
+   *
+   * @param key Key to find
+   * @return Value of the key, std::nullopt if key is absent
+   */
+  std::optional<std::string_view> Find(std::string_view key) const;
+
+  /**
+   * @brief Checks if the tree contains a key.
+   * @param key Key to find
+   * @return true if key is present
+   */
+  bool Contains(std::string_view key) const { return Find(key).has_value(); }
+
+  /**
+   * @brief Removes all keys, keeping the size of the file.
+   */
+  void Clear();
+
+  /**
+   * @brief Returns the number of keys in the tree.
+   */
+  size_t GetSize() const;
+
+  /**
+   * @brief Checks if the tree is empty.
+   */
+  bool IsEmpty() const { return GetSize() == 0; }
+
+  /**
+   * @brief Returns the height of the tree, 0 for an empty one.
+   */
+  size_t GetHeight() const;
+
+  /**
+   * @brief Returns the size of the file in bytes.
+   */
+  size_t GetFileSize() const { return capacity_; }
+
+  /**
+   * @brief Writes all changed pages to the file and waits for the disk.
+   * @throw std::system\_error if writing fails
+   */
+  void Sync();
+
+  /**
+   * @brief In-order traversal of all pairs.
+   *
+   * The tree must not be changed by func.
+   *
+   * @tparam Func Callable as func(std::string\_view key,
+   * std::string\_view value)
+   * @param func Function called for each pair in ascending key order
+   */
+  template <typename Func> void InOrderTraversal(Func func) const {
+    // Threaded (Morris) traversal would write to the file, the stack of
+    // an AVL tree is short
+    uint64_t stack[kMaxHeight];
+    size_t depth = 0;
+    uint64_t node = Root();
+    while (node || depth > 0) {
+      while (node) {
+        stack[depth++] = node;
+        node = LeftOf(node);
+      }
+      node = stack[--depth];
+      func(KeyOf(node), ValueOf(node));
+      node = RightOf(node);
+    }
+  }
+
+private:
+  struct Header;
+  struct Node;
+
+  /// Height limit of an AVL tree with 2^64 nodes
+  static constexpr size_t kMaxHeight = 96;
+
+  std::string path_;          ///< Path of the file
+  int fd_ = -1;               ///< Descriptor of the open file
+  std::byte *base_ = nullptr; ///< Start of the mapping
+  size_t capacity_ = 0;       ///< Size of the file and of the mapping
+
+  /**
+   * @brief Unmaps and closes the file.
+   */
+  void Close() noexcept;
+
+  /**
+   * @brief Maps the whole file of capacity\_ bytes.
+   * @throw std::system\_error if mapping fails
+   */
+  void Map();
+
+  /**
+   * @brief Writes the header of an empty tree to a new file.
+   */
+  void Format();
+
+  /**
+   * @brief Enlarges the file so that a block of given size fits.
+   *
+   * Remaps the file, so every Node pointer taken before is invalid.
+   *
+   * @param bytes Size of the block that must fit at the end
+   * @throw std::system\_error if the file can't grow
+   */
+  void Grow(size_t bytes);
+
+  /**
+   * @brief Ensures that blocks for a new node and its data can be taken
+   * without growing the file.
+   * @param data_bytes Size of the data block
+   */
+  void Reserve(size_t data_bytes);
+
+  /**
+   * @brief Takes a node block, must be preceded by Reserve.
+   * @return Offset of the block
+   */
+  uint64_t AllocateNode();
+
+  /**
+   * @brief Puts a node block to the free list of nodes.
+   * @param node Offset of the block
+   */
+  void FreeNode(uint64_t node);
+
+  /**
+   * @brief Takes a data block of the class of given size, must be
+   * preceded by Reserve.
+   * @param bytes Requested size
+   * @return Offset of the block
+   */
+  uint64_t AllocateData(size_t bytes);
+
+  /**
+   * @brief Puts a data block to the free list of its class.
+   * @param offset Offset of the block
+   * @param bytes Size the block was allocated with
+   */
+  void FreeData(uint64_t offset, size_t bytes);
+
+  /**
+   * @brief Takes the first block of a free list or a new one from the end.
+   * @param free_list Head of the free list in the header
+   * @param block_size Size of blocks of the list
+   * @return Offset of the block
+   */
+  uint64_t Pop(uint64_t &free_list, size_t block_size);
+
+  /**
+   * @brief Puts a block to the front of a free list.
+   *
+   * The offset of the next free block is kept in the first bytes of the
+   * block itself.
+   *
+   * @param free_list Head of the free list in the header
+   * @param block Offset of the block
+   */
+  void Push(uint64_t &free_list, uint64_t block);
+
+  /**
+   * @brief Returns the size class of a data block, blocks of class c take
+   * 16 << c bytes.
+   * @param bytes Requested size
+   */
+  static size_t SizeClass(size_t bytes);
+
+  /**
+   * @brief Returns the header at the start of the mapping.
+   */
+  Header *GetHeader() const;
+
+  /**
+   * @brief Converts an offset to a node pointer, valid until remapping.
+   */
+  Node *At(uint64_t offset) const;
+
+  /**
+   * @brief Returns the offset of the root, 0 for an empty tree.
+   */
+  uint64_t Root() const;
+
+  /**
+   * @brief Returns the offset of the left child of a node.
+   */
+  uint64_t LeftOf(uint64_t node) const;
+
+  /**
+   * @brief Returns the offset of the right child of a node.
+   */
+  uint64_t RightOf(uint64_t node) const;
+
+  /**
+   * @brief Returns the key bytes of a node.
+   */
+  std::string_view KeyOf(uint64_t node) const;
+
+  /**
+   * @brief Returns the value bytes of a node.
+   */
+  std::string_view ValueOf(uint64_t node) const;
+
+  /**
+   * @brief Checks if a view points into the mapping of the file.
+   */
+  bool IsMapped(std::string_view bytes) const;
+
+  /**
+   * @brief Writes key and value into a new data block.
+   * @return Offset of the block
+   */
+  uint64_t StoreData(std::string_view key, std::string_view value);
+
+  /**
+   * @brief Creates a node with its data block.
+   * @return Offset of the node
+   */
+  uint64_t CreateNode(std::string_view key, std::string_view value);
+
+  /**
+   * @brief Frees a node and its data block.
+   * @param node Offset of the node
+   */
+  void DestroyNode(uint64_t node);
+
+  /**
+   * @brief Returns stored height of a subtree, 0 for offset 0.
+   */
+  int32_t HeightOf(uint64_t node) const;
+
+  /**
+   * @brief Recalculates height of a node from its children.
+   */
+  void UpdateHeight(uint64_t node);
+
+  /**
+   * @brief Left rotation around a node.
+   * @param node Offset of the subtree root
+   * @return Offset of the new subtree root
+   */
+  uint64_t RotateLeft(uint64_t node);
+
+  /**
+   * @brief Right rotation around a node.
+   * @param node Offset of the subtree root
+   * @return Offset of the new subtree root
+   */
+  uint64_t RotateRight(uint64_t node);
+
+  /**
+   * @brief Restores the AVL invariant at a node whose children are
+   * balanced.
+   * @param node Offset of the node
+   * @return Offset of the new subtree root
+   */
+  uint64_t Balance(uint64_t node);
+
+  /**
+   * @brief Recursive insertion into a subtree.
+   * @param node Offset of the subtree root, 0 for empty subtree
+   * @param key Key to insert
+   * @param value Value to store
+   * @param inserted Set to true if a node was created
+   * @return Offset of the new subtree root
+   */
+  uint64_t InsertHelper(uint64_t node, std::string_view key,
+                        std::string_view value, bool &inserted);
+
+  /**
+   * @brief Recursive removal from a subtree.
+   * @param node Offset of the subtree root
+   * @param key Key to remove
+   * @param erased Set to true if a node was removed
+   * @return Offset of the new subtree root
+   */
+  uint64_t EraseHelper(uint64_t node, std::string_view key, bool &erased);
+
+  /**
+   * @brief Unlinks the leftmost node of a subtree.
+   * @param node Offset of the subtree root
+   * @param leftmost Set to the offset of the unlinked node
+   * @return Offset of the new subtree root
+   */
+  uint64_t DetachLeftmost(uint64_t node, uint64_t &leftmost);
+};
+
+#endif // MAPPED_TREE_H
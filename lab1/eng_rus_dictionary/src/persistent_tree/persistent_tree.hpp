@@ -0,0 +1,448 @@
+/**
+ * @file persistent_tree.hpp
+ * @brief Persistent (copy-on-write) AVL tree template implementation
+ * @author Dmitry Burbas
+ * @date 14/11/2025
+ */
+
+#ifndef PERSISTENT_TREE_HPP
+#define PERSISTENT_TREE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Persistent key-value AVL tree with O(1) snapshots.
+ *
+ * Nodes are immutable and shared between versions of the tree through
+ * reference counting. Copying a tree is O(1) and gives an independent
+ * snapshot: a later Insert or Erase on either copy rebuilds only the
+ * O(log n) nodes on the path to the changed key (plus O(1) nodes touched
+ * by rotations), all other nodes stay shared. Reference counts are atomic,
+ * so different snapshots may be read and destroyed from different threads.
+ *
+ * Unlike BinarySearchTree there are no parent pointers (a shared node has
+ * many parents), so iterators keep the path from the root on a stack.
+ *
+ * @tparam KeyType Type of keys stored in the tree
+ * @tparam ValueType Type of values associated with keys
+ * @tparam Compare Strict weak ordering of keys, transparent comparators
+ * allow lookups by any key-comparable type
+ */
+template <typename KeyType, typename ValueType,
+          typename Compare = std::less<>>
+class PersistentTree {
+  struct Node;
+
+public:
+  /**
+   * @brief Forward iterator over elements in ascending key order.
+   *
+   * Valid while any copy of the tree version it was taken from is alive.
+   */
+  class ConstIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<const KeyType, ValueType>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    /**
+     * @brief Default constructor. Creates end iterator.
+     */
+    ConstIterator() = default;
+
+    reference operator*() const { return path_.back()->data; }
+    pointer operator->() const { return &path_.back()->data; }
+
+    /**
+     * @brief Moves to the next key in ascending order.
+     * @return Reference to this iterator
+     */
+    ConstIterator &operator++() {
+      const Node *node = path_.back();
+      if (node->right) {
+        PushLeftPath(node->right.get());
+        return *this;
+      }
+      path_.pop_back();
+      while (!path_.empty() && path_.back()->right.get() == node) {
+        node = path_.back();
+        path_.pop_back();
+      }
+      return *this;
+    }
+    ConstIterator operator++(int) {
+      ConstIterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const ConstIterator &other) const {
+      if (path_.empty() || other.path_.empty())
+        return path_.empty() == other.path_.empty();
+      return path_.back() == other.path_.back();
+    }
+    bool operator!=(const ConstIterator &other) const {
+      return !(*this == other);
+    }
+
+  private:
+    friend class PersistentTree;
+
+    std::vector<const Node *> path_; ///< Nodes from root to current one
+
+    /**
+     * @brief Descends to the leftmost node, pushing the path.
+     * @param node Root of subtree to descend into
+     */
+    void PushLeftPath(const Node *node) {
+      while (node) {
+        path_.push_back(node);
+        node = node->left.get();
+      }
+    }
+  };
+  using const_iterator = ConstIterator;
+
+  /**
+   * @brief Default constructor. Creates an empty tree
+   */
+  PersistentTree() = default;
+
+  /**
+   * @brief Takes snapshot of another tree in O(1).
+   * @param other Tree to share nodes with
+   */
+  PersistentTree(const PersistentTree &other) = default;
+
+  /**
+   * @brief Replaces this tree with snapshot of another in O(1).
+   * @param other Tree to share nodes with
+   * @return Reference to this tree
+   */
+  PersistentTree &operator=(const PersistentTree &other) = default;
+
+  /**
+   * @brief Move constructor, leaves other empty.
+   */
+  PersistentTree(PersistentTree &&other) noexcept
+      : compare_(other.compare_), root_(std::move(other.root_)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  /**
+   * @brief Move assignment operator, leaves other empty.
+   */
+  PersistentTree &operator=(PersistentTree &&other) noexcept {
+    if (this != &other) {
+      compare_ = other.compare_;
+      root_ = std::move(other.root_);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Returns snapshot of the tree, same as copying it.
+   * @return Tree sharing all nodes with this one
+   */
+  PersistentTree Snapshot() const { return *this; }
+
+  /**
+   * @brief Access element by key.
+   * @param key Key to find
+   * @return Const reference to the value
+   * @throw std::out_of_range if key not found
+   */
+  const ValueType &operator[](const KeyType &key) const {
+    const ValueType *found = Find(key);
+    if (!found) {
+      throw std::out_of_range("Key not found");
+    }
+    return *found;
+  }
+
+  /**
+   * @brief Equality comparison operator.
+   *
+   * Trees are equal if they contain equal keys with equal values. Shared
+   * subtrees are equal without being walked only when both trees are the
+   * same version, otherwise elements are compared in key order.
+   *
+   * @param other Tree to compare with
+   * @return true if trees are equal, false otherwise
+   */
+  bool operator==(const PersistentTree &other) const {
+    if (size_ != other.size_)
+      return false;
+    if (root_ == other.root_)
+      return true;
+    for (auto it = begin(), other_it = other.begin(); it != end();
+         ++it, ++other_it) {
+      if (!(it->first == other_it->first && it->second == other_it->second))
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Inequality comparison operator.
+   * @param other Tree to compare with
+   * @return true if trees are not equal, false otherwise
+   */
+  bool operator!=(const PersistentTree &other) const {
+    return !(*this == other);
+  }
+
+  /**
+   * @brief Inserts a key-value pair or replaces value of existing key.
+   *
+   * Copies the nodes on the path to the key, other snapshots don't see the
+   * change.
+   *
+   * @param key Key to insert
+   * @param value Value to associate with the key
+   * @return true if new element was inserted, false if existing was updated
+   */
+  bool Insert(const KeyType &key, ValueType value) {
+    bool inserted = false;
+    root_ = InsertHelper(root_, key, value, inserted);
+    if (inserted)
+      ++size_;
+    return inserted;
+  }
+
+  /**
+   * @brief Searches for a key in the tree.
+   * @param key Key to find, any type comparable with KeyType if Compare is
+   * transparent
+   * @return Pointer to value if found, nullptr otherwise
+   */
+  template <typename K = KeyType> const ValueType *Find(const K &key) const {
+    const Node *current = root_.get();
+    while (current) {
+      if (compare_(key, current->data.first)) {
+        current = current->left.get();
+      } else if (compare_(current->data.first, key)) {
+        current = current->right.get();
+      } else {
+        return &current->data.second;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Checks if the tree contains a key.
+   * @param key Key to find
+   * @return true if key is present, false otherwise
+   */
+  template <typename K = KeyType> bool Contains(const K &key) const {
+    return Find(key) != nullptr;
+  }
+
+  /**
+   * @brief Removes element with specified key.
+   *
+   * Copies the nodes on the path to the key, other snapshots don't see the
+   * change.
+   *
+   * @param key Key to remove
+   * @return true if element was removed, false if key not found
+   */
+  template <typename K = KeyType> bool Erase(const K &key) {
+    if (!Contains(key))
+      return false;
+    root_ = EraseHelper(root_, key);
+    --size_;
+    return true;
+  }
+
+  /**
+   * @brief Removes all elements from this tree, snapshots are not affected.
+   */
+  void Clear() {
+    root_.reset();
+    size_ = 0;
+  }
+
+  /**
+   * @brief Checks if the tree is empty.
+   * @return true if tree contains no elements, false otherwise
+   */
+  bool IsEmpty() const { return size_ == 0; }
+
+  /**
+   * @brief Returns the number of elements in the tree.
+   * @return Size of the tree
+   */
+  size_t GetSize() const { return size_; }
+
+  /**
+   * @brief Returns the height of the tree.
+   * @return Number of nodes on the longest root-to-leaf path
+   */
+  size_t GetHeight() const { return static_cast<size_t>(Height(root_)); }
+
+  /**
+   * @brief Performs in-order traversal of the tree.
+   * @tparam Func Function type with signature void(const KeyType&, const
+   * ValueType&)
+   * @param func Callback function to apply to each node
+   */
+  template <typename Func> void InOrderTraversal(Func func) const {
+    for (const auto &pair : *this)
+      func(pair.first, pair.second);
+  }
+
+  const_iterator begin() const {
+    ConstIterator it;
+    it.PushLeftPath(root_.get());
+    return it;
+  }
+  const_iterator end() const { return ConstIterator(); }
+
+private:
+  using NodePtr = std::shared_ptr<const Node>;
+
+  /**
+   * @brief Immutable node shared between tree versions.
+   */
+  struct Node {
+    std::pair<const KeyType, ValueType> data; ///< Node key and value
+    NodePtr left;                             ///< Left child
+    NodePtr right;                            ///< Right child
+    int height;                               ///< Height of the subtree
+  };
+
+  Compare compare_;  ///< Ordering of keys
+  NodePtr root_;     ///< Root node of this version
+  size_t size_ = 0;  ///< Number of elements in this version
+
+  /**
+   * @brief Returns stored height of a node, 0 for nullptr.
+   */
+  static int Height(const NodePtr &node) { return node ? node->height : 0; }
+
+  /**
+   * @brief Creates a node over given children without rebalancing.
+   */
+  template <typename Data>
+  static NodePtr MakeNode(Data &&data, NodePtr left, NodePtr right) {
+    int height = 1 + std::max(Height(left), Height(right));
+    return std::make_shared<const Node>(Node{
+        std::forward<Data>(data), std::move(left), std::move(right), height});
+  }
+
+  /**
+   * @brief Creates a node over given children restoring AVL invariant.
+   *
+   * Children heights may differ by at most two, as after a single
+   * insertion or removal below.
+   *
+   * @param data Key and value of the node
+   * @param left New left subtree
+   * @param right New right subtree
+   * @return Root of the balanced subtree
+   */
+  template <typename Data>
+  static NodePtr Balance(Data &&data, NodePtr left, NodePtr right) {
+    int balance = Height(left) - Height(right);
+    if (balance > 1) {
+      if (Height(left->left) >= Height(left->right)) {
+        return MakeNode(left->data, left->left,
+                        MakeNode(std::forward<Data>(data), left->right,
+                                 std::move(right)));
+      }
+      const Node *pivot = left->right.get();
+      return MakeNode(pivot->data,
+                      MakeNode(left->data, left->left, pivot->left),
+                      MakeNode(std::forward<Data>(data), pivot->right,
+                               std::move(right)));
+    }
+    if (balance < -1) {
+      if (Height(right->right) >= Height(right->left)) {
+        return MakeNode(right->data,
+                        MakeNode(std::forward<Data>(data), std::move(left),
+                                 right->left),
+                        right->right);
+      }
+      const Node *pivot = right->left.get();
+      return MakeNode(pivot->data,
+                      MakeNode(std::forward<Data>(data), std::move(left),
+                               pivot->left),
+                      MakeNode(right->data, pivot->right, right->right));
+    }
+    return MakeNode(std::forward<Data>(data), std::move(left),
+                    std::move(right));
+  }
+
+  /**
+   * @brief Recursively inserts into a copy of the path.
+   * @param node Root of the subtree in the old version
+   * @param key Key to insert
+   * @param value Value to insert, moved into the new node
+   * @param inserted Output parameter, true if key was absent
+   * @return Root of the subtree in the new version
+   */
+  NodePtr InsertHelper(const NodePtr &node, const KeyType &key,
+                       ValueType &value, bool &inserted) {
+    if (!node) {
+      inserted = true;
+      return MakeNode(std::pair<const KeyType, ValueType>(key, std::move(value)),
+                      nullptr, nullptr);
+    }
+    if (compare_(key, node->data.first)) {
+      return Balance(node->data, InsertHelper(node->left, key, value, inserted),
+                     node->right);
+    }
+    if (compare_(node->data.first, key)) {
+      return Balance(node->data, node->left,
+                     InsertHelper(node->right, key, value, inserted));
+    }
+    return MakeNode(std::pair<const KeyType, ValueType>(node->data.first,
+                                                        std::move(value)),
+                    node->left, node->right);
+  }
+
+  /**
+   * @brief Recursively removes a key present in the subtree.
+   * @param node Root of the subtree in the old version
+   * @param key Key to remove
+   * @return Root of the subtree in the new version
+   */
+  template <typename K> NodePtr EraseHelper(const NodePtr &node, const K &key) {
+    if (compare_(key, node->data.first))
+      return Balance(node->data, EraseHelper(node->left, key), node->right);
+    if (compare_(node->data.first, key))
+      return Balance(node->data, node->left, EraseHelper(node->right, key));
+    if (!node->left)
+      return node->right;
+    if (!node->right)
+      return node->left;
+    const Node *successor = node->right.get();
+    while (successor->left)
+      successor = successor->left.get();
+    return Balance(successor->data, node->left, EraseMin(node->right));
+  }
+
+  /**
+   * @brief Recursively removes the smallest key of a subtree.
+   * @param node Root of non-empty subtree in the old version
+   * @return Root of the subtree in the new version
+   */
+  static NodePtr EraseMin(const NodePtr &node) {
+    if (!node->left)
+      return node->right;
+    return Balance(node->data, EraseMin(node->left), node->right);
+  }
+};
+
+#endif // PERSISTENT_TREE_HPP
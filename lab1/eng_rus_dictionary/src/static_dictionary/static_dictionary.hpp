@@ -0,0 +1,371 @@
+/**
+ * @file static_dictionary.hpp
+ * @brief English-Russian dictionary built at compile time
+ * @author Dmitry Burbas
+ * @date 21/11/2025
+ */
+
+#ifndef STATIC_DICTIONARY_HPP
+#define STATIC_DICTIONARY_HPP
+
+#include "../dictionary_utils/dictionary_utils.h"
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * @brief Counts word pairs in a text in format of dictionary files.
+ *
+ * Every non-empty line is one word pair "english:russian". Gives the size
+ * parameter of StaticDictionary at compile time.
+ *
+ * @param text Word pairs, one per line
+ * @return Number of non-empty lines
+ */
+constexpr size_t CountWordPairs(std::string_view text) {
+  size_t count = 0;
+  size_t line_start = 0;
+  while (line_start < text.size()) {
+    size_t line_end = text.find('\n', line_start);
+    if (line_end == std::string_view::npos)
+      line_end = text.size();
+    if (line_end > line_start)
+      ++count;
+    line_start = line_end + 1;
+  }
+  return count;
+}
+
+/**
+ * @brief Read-only dictionary whose sorted table is computed by the
+ * compiler.
+ *
+ * The constructor parses a text in the format of dictionary files
+ * ("english:russian" per line), checks every word and sorts the pairs.
+ * Declared constexpr, the object is finished during compilation: the table
+ * and the text it points into are placed in read-only data of the program
+ * and nothing runs at startup. A malformed line or a repeated English word
+ * is a compilation error instead of a line silently skipped as in
+ * Dictionary::LoadFromFile. Lookups are binary searches over the table and
+ * can also be evaluated at compile time.
+ *
+ * The dictionary only views the text, which must outlive it. A string
+ * literal lives for the whole program.
+ *
+ * @tparam N Number of word pairs, see CountWordPairs
+ *
+ * @code
+ * constexpr std::string_view kText = R"(hello:привет
+ * apple:яблоко
+ * )";
+ * constexpr StaticDictionary<CountWordPairs(kText)> kDict(kText);
+ * static_assert(kDict.Contains("apple"));
+ * std::cout << kDict["hello"]; // Outputs: привет
+ * @endcode
+ */
+template <size_t N> class StaticDictionary {
+public:
+  /**
+   * @brief English word and its Russian translation.
+   */
+  struct WordPair {
+    std::string_view first;  ///< English word
+    std::string_view second; ///< Russian translation
+  };
+
+  using const_iterator = const WordPair *;
+  using Range = std::pair<const_iterator, const_iterator>;
+
+  /**
+   * @brief Parses and sorts word pairs of a text.
+   * @param text Exactly N word pairs "english:russian", one per line,
+   * empty lines are ignored
+   * @throw std::invalid\_argument if a line is not a valid word pair, a
+   * word repeats or the number of pairs is not N (a compilation error in
+   * constant evaluation)
+   */
+  constexpr explicit StaticDictionary(std::string_view text) : pairs_{} {
+    size_t count = 0;
+    size_t line_start = 0;
+    while (line_start < text.size()) {
+      size_t line_end = text.find('\n', line_start);
+      if (line_end == std::string_view::npos)
+        line_end = text.size();
+      std::string_view line = text.substr(line_start, line_end - line_start);
+      line_start = line_end + 1;
+      if (line.empty())
+        continue;
+      if (count == N)
+        throw std::invalid_argument("StaticDictionary: too many word pairs");
+      pairs_[count++] = ParseWordPair(line);
+    }
+    if (count != N)
+      throw std::invalid_argument("StaticDictionary: too few word pairs");
+    Sort();
+    for (size_t index = 1; index < N; ++index) {
+      if (pairs_[index - 1].first == pairs_[index].first)
+        throw std::invalid_argument("StaticDictionary: repeated word");
+    }
+  }
+
+  /**
+   * @brief Looks up translation of a word.
+   * @param english_word Word to look up
+   * @return Pointer to Russian translation, nullptr if word is not present
+   */
+  constexpr const std::string_view *Find(std::string_view english_word) const {
+    size_t index = LowerBoundIndex(english_word);
+    if (index == N || pairs_[index].first != english_word)
+      return nullptr;
+    return &pairs_[index].second;
+  }
+
+  /**
+   * @brief Checks if the dictionary contains a word.
+   * @param english_word Word to look up
+   * @return true if word is present
+   */
+  constexpr bool Contains(std::string_view english_word) const {
+    return Find(english_word) != nullptr;
+  }
+
+  /**
+   * @brief Accesses translation of an English word.
+   * @param english_word English word to look up
+   * @return Russian translation
+   * @throw std::invalid\_argument if word is not valid English
+   * @throw std::out\_of\_range if word not found
+   */
+  constexpr std::string_view operator[](std::string_view english_word) const {
+    if (!utils::IsEnglishWord(english_word)) {
+      throw std::invalid_argument(
+          "Invalid argument format: word must be english");
+    }
+    const std::string_view *translation = Find(english_word);
+    if (!translation) {
+      throw std::out_of_range("Word not found: " + std::string(english_word));
+    }
+    return *translation;
+  }
+
+  /**
+   * @brief Finds all word pairs with English word in [first_word, last_word].
+   * @param first_word Lower bound of the range, inclusive
+   * @param last_word Upper bound of the range, inclusive
+   * @return Range of matching word pairs, empty if last_word < first_word
+   * @throw std::invalid\_argument if bounds are not valid English words
+   */
+  constexpr Range FindRange(std::string_view first_word,
+                            std::string_view last_word) const {
+    if (!utils::IsEnglishWord(first_word) ||
+        !utils::IsEnglishWord(last_word)) {
+      throw std::invalid_argument(
+          "Invalid argument format: range bounds must be english");
+    }
+    if (last_word < first_word)
+      return {end(), end()};
+    return {begin() + LowerBoundIndex(first_word),
+            begin() + UpperBoundIndex(last_word)};
+  }
+
+  /**
+   * @brief Finds all word pairs whose English word starts with prefix.
+   * @param prefix Beginning of English words, empty prefix matches all
+   * @return Range of matching word pairs
+   * @throw std::invalid\_argument if prefix is not valid English
+   */
+  constexpr Range FindPrefix(std::string_view prefix) const {
+    if (prefix.empty())
+      return {begin(), end()};
+    if (!utils::IsEnglishWord(prefix)) {
+      throw std::invalid_argument(
+          "Invalid argument format: prefix must be english");
+    }
+    // Words starting with prefix are a contiguous run, cutting every word
+    // to the length of prefix keeps the table sorted
+    size_t low = LowerBoundIndex(prefix);
+    size_t high = N;
+    for (size_t first = low; first < high;) {
+      size_t middle = first + (high - first) / 2;
+      if (pairs_[middle].first.substr(0, prefix.size()) == prefix)
+        first = middle + 1;
+      else
+        high = middle;
+    }
+    return {begin() + low, begin() + high};
+  }
+
+  /**
+   * @brief Returns word pair with given position in alphabetical order.
+   * @param index Zero-based position of the word
+   * @return Iterator to the word pair, end() if index >= GetSize()
+   */
+  constexpr const_iterator Select(size_t index) const {
+    return index < N ? begin() + index : end();
+  }
+
+  /**
+   * @brief Counts words alphabetically less than the given one.
+   * @param english_word Word to rank, need not be in the dictionary
+   * @return Position the word has or would have in alphabetical order
+   * @throw std::invalid\_argument if word is not valid English
+   */
+  constexpr size_t Rank(std::string_view english_word) const {
+    if (!utils::IsEnglishWord(english_word)) {
+      throw std::invalid_argument(
+          "Invalid argument format: word must be english");
+    }
+    return LowerBoundIndex(english_word);
+  }
+
+  /**
+   * @brief Counts words in [first_word, last_word] in O(log n).
+   * @param first_word Lower bound of the range, inclusive
+   * @param last_word Upper bound of the range, inclusive
+   * @return Number of words in the range, 0 if last_word < first_word
+   * @throw std::invalid\_argument if bounds are not valid English words
+   */
+  constexpr size_t CountRange(std::string_view first_word,
+                              std::string_view last_word) const {
+    Range range = FindRange(first_word, last_word);
+    return static_cast<size_t>(range.second - range.first);
+  }
+
+  /**
+   * @brief Returns the number of word pairs in the dictionary.
+   * @return Size of dictionary
+   */
+  constexpr size_t GetSize() const { return N; }
+
+  /**
+   * @brief Checks if dictionary is empty.
+   * @return true if dictionary contains no entries
+   */
+  constexpr bool IsEmpty() const { return N == 0; }
+
+  /**
+   * @brief Returns iterator to the alphabetically first word pair.
+   */
+  constexpr const_iterator begin() const { return pairs_.data(); }
+
+  /**
+   * @brief Returns iterator past the last word pair.
+   */
+  constexpr const_iterator end() const { return pairs_.data() + N; }
+
+  /**
+   * @brief Output stream operator. Prints all word pairs in format
+   * "english:russian" in alphabetical order.
+   * @param out_stream Output stream
+   * @param dict Dictionary to output
+   * @return Reference to output stream
+   */
+  friend std::ostream &operator<<(std::ostream &out_stream,
+                                  const StaticDictionary &dict) {
+    for (const WordPair &word_pair : dict) {
+      out_stream << word_pair.first << WORD_PAIR_DELIMETER
+                 << word_pair.second << "\n";
+    }
+    return out_stream;
+  }
+
+private:
+  std::array<WordPair, N> pairs_; ///< Word pairs sorted by English word
+
+  /**
+   * @brief Splits a line into a checked word pair.
+   * @param line Line in format "english:russian"
+   * @return Views of both words into the line
+   * @throw std::invalid\_argument if the line is not a valid word pair
+   */
+  static constexpr WordPair ParseWordPair(std::string_view line) {
+    WordPair word_pair{};
+    if (!utils::SplitWordPair(line, word_pair.first, word_pair.second))
+      throw std::invalid_argument("StaticDictionary: invalid word pair");
+    return word_pair;
+  }
+
+  /**
+   * @brief Sorts pairs by English word with heapsort.
+   *
+   * std::sort is not constexpr before C++20. Heapsort needs O(n log n)
+   * steps and no extra memory, which keeps large vocabularies within the
+   * limits of constant evaluation.
+   */
+  constexpr void Sort() {
+    for (size_t index = N / 2; index > 0; --index)
+      SiftDown(index - 1, N);
+    for (size_t size = N; size > 1; --size) {
+      Swap(0, size - 1);
+      SiftDown(0, size - 1);
+    }
+  }
+
+  /**
+   * @brief Moves a pair down the max-heap until its children are smaller.
+   * @param index Position of the pair
+   * @param size Number of pairs in the heap
+   */
+  constexpr void SiftDown(size_t index, size_t size) {
+    while (2 * index + 1 < size) {
+      size_t child = 2 * index + 1;
+      if (child + 1 < size && pairs_[child].first < pairs_[child + 1].first)
+        ++child;
+      if (!(pairs_[index].first < pairs_[child].first))
+        return;
+      Swap(index, child);
+      index = child;
+    }
+  }
+
+  /**
+   * @brief Exchanges two pairs, std::swap is not constexpr before C++20.
+   */
+  constexpr void Swap(size_t first, size_t second) {
+    WordPair word_pair = pairs_[first];
+    pairs_[first] = pairs_[second];
+    pairs_[second] = word_pair;
+  }
+
+  /**
+   * @brief Finds position of the first word not less than the given one.
+   * @param english_word Word to search for
+   * @return Index in [0, N]
+   */
+  constexpr size_t LowerBoundIndex(std::string_view english_word) const {
+    size_t first = 0;
+    size_t last = N;
+    while (first < last) {
+      size_t middle = first + (last - first) / 2;
+      if (pairs_[middle].first < english_word)
+        first = middle + 1;
+      else
+        last = middle;
+    }
+    return first;
+  }
+
+  /**
+   * @brief Finds position of the first word greater than the given one.
+   * @param english_word Word to search for
+   * @return Index in [0, N]
+   */
+  constexpr size_t UpperBoundIndex(std::string_view english_word) const {
+    size_t first = 0;
+    size_t last = N;
+    while (first < last) {
+      size_t middle = first + (last - first) / 2;
+      if (english_word < pairs_[middle].first)
+        last = middle;
+      else
+        first = middle + 1;
+    }
+    return first;
+  }
+};
+
+#endif // STATIC_DICTIONARY_HPP
@@ -0,0 +1,143 @@
+//
+//  binary_dictionary_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 23/11/2025.
+//
+
+#include "../src/binary_dictionary/binary_dictionary.h"
+#include "../src/dictionary/dictionary.h"
+#include "temp_path.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+class BinaryDictionaryFixture : public testing::Test {
+protected:
+  void SetUp() override {
+    dict += "test:тест";
+    dict += "food:еда";
+    dict += "apple:яблоко";
+    dict += "mushroom:гриб";
+    dict += "programmer:программист";
+    dict += "Object-Oriented-Programming:ООП";
+    ASSERT_TRUE(dict.SaveBinary(path.Get()));
+  }
+
+  Dictionary dict;
+  TempPath path{"binary_dictionary_test.sst"};
+};
+
+TEST_F(BinaryDictionaryFixture, FindAndAccess) {
+  BinaryDictionary binary = Dictionary::OpenBinary(path.Get());
+  ASSERT_EQ(binary.GetSize(), 6);
+  ASSERT_FALSE(binary.IsEmpty());
+  ASSERT_EQ(binary["food"], "еда");
+  ASSERT_EQ(binary["Object-Oriented-Programming"], "ООП");
+  ASSERT_EQ(*binary.Find("test"), "тест");
+  ASSERT_TRUE(binary.Contains("mushroom"));
+  ASSERT_FALSE(binary.Contains("zebra"));
+  ASSERT_FALSE(binary.Contains("AAA"));
+  ASSERT_FALSE(binary.Find("foo"));
+  ASSERT_THROW(binary["zebra"], std::out_of_range);
+  ASSERT_THROW(binary["еда"], std::invalid_argument);
+}
+TEST_F(BinaryDictionaryFixture, OutputMatchesDictionary) {
+  BinaryDictionary binary(path.Get());
+  std::ostringstream expected;
+  std::ostringstream actual;
+  expected << dict;
+  actual << binary;
+  ASSERT_EQ(actual.str(), expected.str());
+}
+TEST_F(BinaryDictionaryFixture, ChecksumDetectsCorruption) {
+  ASSERT_TRUE(BinaryDictionary(path.Get()).VerifyChecksum());
+  {
+    // Last byte of the file belongs to the sparse index
+    std::fstream file(path.Get(),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('\x7f');
+  }
+  ASSERT_FALSE(BinaryDictionary(path.Get()).VerifyChecksum());
+}
+TEST(BinaryDictionaryNonFixture, ManyWordsAcrossRestarts) {
+  // Shared prefixes exercise front coding, 1000 words span many groups
+  Dictionary dict;
+  std::mt19937 generator(7);
+  for (size_t index = 0; index < 1000; ++index) {
+    std::string word = "pre";
+    for (size_t letter = generator() % 5; letter > 0; --letter)
+      word += static_cast<char>('a' + generator() % 26);
+    dict += word + (index % 2 ? ":слово" : ":другое");
+  }
+  TempPath path("binary_dictionary_many.sst");
+  ASSERT_TRUE(dict.SaveBinary(path.Get()));
+  BinaryDictionary binary(path.Get());
+  ASSERT_EQ(binary.GetSize(), dict.GetSize());
+  ASSERT_TRUE(binary.VerifyChecksum());
+  for (const auto &[english_word, russian_word] : dict)
+    ASSERT_EQ(binary[english_word], russian_word) << english_word;
+  ASSERT_FALSE(binary.Contains("pr"));
+  ASSERT_FALSE(binary.Contains("prezzzzz"));
+  size_t count = 0;
+  binary.InOrderTraversal(
+      [&count](std::string_view, std::string_view) { ++count; });
+  ASSERT_EQ(count, dict.GetSize());
+}
+TEST(BinaryDictionaryNonFixture, EmptyDictionary) {
+  TempPath path("binary_dictionary_empty.sst");
+  ASSERT_TRUE(Dictionary().SaveBinary(path.Get()));
+  BinaryDictionary binary(path.Get());
+  ASSERT_TRUE(binary.IsEmpty());
+  ASSERT_FALSE(binary.Contains("word"));
+  ASSERT_TRUE(binary.VerifyChecksum());
+}
+TEST(BinaryDictionaryNonFixture, RejectsOtherFiles) {
+  TempPath path("binary_dictionary_text.txt");
+  std::ofstream(path.Get()) << "hello:привет\nworld:мир\n";
+  ASSERT_THROW(BinaryDictionary binary(path.Get()), std::runtime_error);
+  ASSERT_THROW(Dictionary::OpenBinary(path.Get() + ".missing"),
+               std::system_error);
+}
+TEST(BinaryDictionaryNonFixture, WriterRequiresIncreasingWords) {
+  TempPath path("binary_dictionary_unused.sst");
+  BinaryDictionary::Writer writer(path.Get());
+  writer.Add("beta", "бета");
+  ASSERT_THROW(writer.Add("alpha", "альфа"), std::invalid_argument);
+  ASSERT_THROW(writer.Add("beta", "бета"), std::invalid_argument);
+}
+TEST(BinaryDictionaryNonFixture, ConvertMatchesLoadFromFile) {
+  TempPath text_path("binary_dictionary_convert.txt");
+  TempPath binary_path("binary_dictionary_convert.sst");
+  {
+    const char *translations[] = {"один", "два", "три", "четыре"};
+    std::mt19937 generator(11);
+    std::ofstream file(text_path.Get());
+    for (size_t line = 0; line < 40000; ++line) {
+      std::string word(1 + generator() % 3, 'a');
+      for (char &letter : word)
+        letter = static_cast<char>('a' + generator() % 26);
+      if (line % 89 == 0)
+        file << "bad line\n";
+      file << word << ":" << translations[generator() % 4] << "\n";
+    }
+  }
+  Dictionary expected;
+  ASSERT_TRUE(expected.LoadFromFile(text_path.Get()));
+  std::ostringstream expected_output;
+  expected_output << expected;
+  for (size_t thread_count : {1, 3}) {
+    ASSERT_TRUE(Dictionary::ConvertToBinary(text_path.Get(),
+                                            binary_path.Get(), thread_count));
+    std::ostringstream output;
+    output << Dictionary::OpenBinary(binary_path.Get());
+    ASSERT_EQ(output.str(), expected_output.str()) << thread_count;
+  }
+  ASSERT_FALSE(Dictionary::ConvertToBinary(text_path.Get() + ".missing",
+                                           binary_path.Get()));
+}
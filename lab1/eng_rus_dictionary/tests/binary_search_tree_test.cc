@@ -5,8 +5,38 @@
 //  Created by Dmitry Burbas on 17/10/2025.
 //
 #include "../src/binary_search_tree/binary_search_tree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Installs a default memory resource for its lifetime.
+ */
+class DefaultResourceGuard {
+public:
+  explicit DefaultResourceGuard(std::pmr::memory_resource *resource)
+      : previous_(std::pmr::set_default_resource(resource)) {}
+  DefaultResourceGuard(const DefaultResourceGuard &) = delete;
+  DefaultResourceGuard &operator=(const DefaultResourceGuard &) = delete;
+  ~DefaultResourceGuard() { std::pmr::set_default_resource(previous_); }
+
+private:
+  std::pmr::memory_resource *previous_; ///< Default before the guard
+};
+
+} // namespace
 
 class BinarySearchTreeFixture : public ::testing::Test {
 protected:
@@ -171,3 +201,686 @@ TEST_F(BinarySearchTreeFixture, InOrderTraversalWorks) {
       {"seven", 7}, {"six", 6},  {"three", 3}};
   ASSERT_EQ(result, expected);
 }
+TEST(BinarySearchTreeNonFixture, SortedInsertKeepsLogarithmicHeight) {
+  BinarySearchTree<int, int> tree;
+  const int count = 100000;
+  for (int i = 0; i < count; ++i) {
+    tree.Insert(i, i);
+  }
+  ASSERT_EQ(count, tree.GetSize());
+  ASSERT_LE(tree.GetHeight(), 1.45 * std::log2(count + 2));
+  BinarySearchTree<int, int> copy(tree);
+  ASSERT_TRUE(copy == tree);
+  for (int i = 0; i < count; i += 2) {
+    ASSERT_TRUE(tree.Erase(i));
+  }
+  ASSERT_EQ(count / 2, tree.GetSize());
+  ASSERT_LE(tree.GetHeight(), 1.45 * std::log2(count / 2 + 2));
+  ASSERT_EQ(nullptr, tree.Find(0));
+  ASSERT_EQ(1, *tree.Find(1));
+}
+TEST(BinarySearchTreeNonFixture, RandomInsertEraseMatchesStdMap) {
+  BinarySearchTree<int, int> tree;
+  std::map<int, int> expected;
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> key_distribution(0, 2000);
+  for (int i = 0; i < 20000; ++i) {
+    int key = key_distribution(generator);
+    if (generator() % 3 == 0) {
+      ASSERT_EQ(expected.erase(key) == 1, tree.Erase(key));
+    } else {
+      ASSERT_EQ(expected.insert_or_assign(key, i).second, tree.Insert(key, i));
+    }
+  }
+  std::vector<std::pair<int, int>> result;
+  tree.InOrderTraversal([&](const int &key, const int &value) {
+    result.push_back({key, value});
+  });
+  std::vector<std::pair<int, int>> expected_pairs(expected.begin(),
+                                                 expected.end());
+  ASSERT_EQ(result, expected_pairs);
+  ASSERT_LE(tree.GetHeight(), 1.45 * std::log2(expected.size() + 2));
+}
+TEST(BinarySearchTreeNonFixture, NoBalancingKeepsInsertionShape) {
+  BinarySearchTree<int, int, NoBalancing> tree;
+  for (int i = 0; i < 100; ++i) {
+    tree.Insert(i, i);
+  }
+  ASSERT_EQ(100, tree.GetHeight());
+  ASSERT_TRUE(tree.Erase(50));
+  ASSERT_EQ(99, tree.GetHeight());
+  ASSERT_EQ(nullptr, tree.Find(50));
+  ASSERT_EQ(51, *tree.Find(51));
+}
+TEST(BinarySearchTreeNonFixture, PoolAllocationMatchesStdMap) {
+  BinarySearchTree<std::string, int, AvlBalancing, PoolNodeAllocation> tree;
+  std::map<std::string, int> expected;
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<int> key_distribution(0, 1000);
+  for (int i = 0; i < 10000; ++i) {
+    std::string key = std::to_string(key_distribution(generator));
+    if (generator() % 3 == 0) {
+      ASSERT_EQ(expected.erase(key) == 1, tree.Erase(key));
+    } else {
+      expected[key] = i;
+      tree.Insert(key, i);
+    }
+  }
+  BinarySearchTree<std::string, int, AvlBalancing, PoolNodeAllocation> copy;
+  copy = tree;
+  ASSERT_TRUE(copy == tree);
+  tree.Clear();
+  ASSERT_TRUE(tree.IsEmpty());
+  tree.Insert("reused", 1);
+  ASSERT_EQ(1, *tree.Find("reused"));
+  std::vector<std::pair<std::string, int>> result;
+  copy.InOrderTraversal([&](const std::string &key, const int &value) {
+    result.push_back({key, value});
+  });
+  std::vector<std::pair<std::string, int>> expected_pairs(expected.begin(),
+                                                         expected.end());
+  ASSERT_EQ(result, expected_pairs);
+}
+TEST(BinarySearchTreeNonFixture, PoolReserveKeepsUnusedSlots) {
+  struct Node {
+    std::pair<const int, int> data;
+    Node(int key, int value) : data(key, value) {}
+  };
+  // Room for two slabs of 10 nodes, not for a third one
+  alignas(std::max_align_t) std::byte buffer[256];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+  PoolNodeAllocation::Allocator<Node> allocator(&arena);
+  std::vector<Node *> nodes;
+  allocator.Reserve(10);
+  nodes.push_back(allocator.Create(0, 0));
+  nodes.push_back(allocator.Create(1, 1));
+  allocator.Reserve(10);
+  // Slots left in the first slab are reused instead of a new slab
+  for (int i = 2; i < 20; ++i)
+    ASSERT_NO_THROW(nodes.push_back(allocator.Create(i, i)));
+  for (Node *node : nodes)
+    allocator.Destroy(node);
+}
+TEST(BinarySearchTreeNonFixture, SwapExchangesContents) {
+  BinarySearchTree<int, int, AvlBalancing, PoolNodeAllocation> first;
+  BinarySearchTree<int, int, AvlBalancing, PoolNodeAllocation> second;
+  first.Insert(1, 10);
+  second.Insert(2, 20);
+  second.Insert(3, 30);
+  first.Swap(second);
+  ASSERT_EQ(2, first.GetSize());
+  ASSERT_EQ(20, *first.Find(2));
+  ASSERT_EQ(1, second.GetSize());
+  ASSERT_EQ(10, *second.Find(1));
+}
+TEST_F(BinarySearchTreeFixture, IteratorsWalkInOrder) {
+  std::vector<std::string> keys;
+  for (const auto &pair : test_tree) {
+    keys.push_back(pair.first);
+  }
+  std::vector<std::string> expected = {"five",  "four", "nine",
+                                       "seven", "six",  "three"};
+  ASSERT_EQ(keys, expected);
+  std::vector<std::string> reversed_keys;
+  for (auto it = test_tree.end(); it != test_tree.begin();) {
+    --it;
+    reversed_keys.push_back(it->first);
+  }
+  ASSERT_EQ(reversed_keys,
+            std::vector<std::string>(expected.rbegin(), expected.rend()));
+}
+TEST_F(BinarySearchTreeFixture, IteratorChangesValue) {
+  for (auto &pair : test_tree) {
+    pair.second *= 10;
+  }
+  ASSERT_EQ(50, *test_tree.Find("five"));
+  ASSERT_EQ(30, *test_tree.Find("three"));
+}
+TEST_F(BinarySearchTreeFixture, LowerAndUpperBound) {
+  ASSERT_EQ("four", test_tree.lower_bound("four")->first);
+  ASSERT_EQ("nine", test_tree.upper_bound("four")->first);
+  ASSERT_EQ("five", test_tree.lower_bound("a")->first);
+  ASSERT_EQ("seven", test_tree.lower_bound("o")->first);
+  ASSERT_TRUE(test_tree.lower_bound("zero") == test_tree.end());
+  ASSERT_TRUE(test_tree.upper_bound("three") == test_tree.end());
+  auto range = test_tree.equal_range("six");
+  ASSERT_EQ("six", range.first->first);
+  ASSERT_EQ("three", range.second->first);
+  range = test_tree.equal_range("sixty");
+  ASSERT_TRUE(range.first == range.second);
+}
+TEST(BinarySearchTreeNonFixture, IteratorsOnEmptyTree) {
+  const BinarySearchTree<std::string, int> tree;
+  ASSERT_TRUE(tree.begin() == tree.end());
+  ASSERT_TRUE(tree.lower_bound("key") == tree.end());
+}
+namespace {
+/**
+ * @brief Value type that counts how many times it was copied.
+ */
+struct CopyCounter {
+  static inline int copies = 0;
+  int value = 0;
+  CopyCounter() = default;
+  explicit CopyCounter(int number) : value(number) {}
+  CopyCounter(const CopyCounter &other) : value(other.value) { ++copies; }
+  CopyCounter(CopyCounter &&other) noexcept = default;
+  CopyCounter &operator=(const CopyCounter &other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  CopyCounter &operator=(CopyCounter &&other) noexcept = default;
+  bool operator==(const CopyCounter &other) const {
+    return value == other.value;
+  }
+};
+} // namespace
+TEST(BinarySearchTreeNonFixture, MoveInsertDoesNotCopy) {
+  BinarySearchTree<std::string, CopyCounter> tree;
+  CopyCounter::copies = 0;
+  tree.Insert(std::string("one"), CopyCounter(1));
+  tree.Insert(std::string("one"), CopyCounter(11));
+  tree.TryEmplace("two", 2);
+  tree.Emplace(std::string("three"), CopyCounter(3));
+  tree["four"].value = 4;
+  ASSERT_EQ(0, CopyCounter::copies);
+  ASSERT_EQ(11, tree.Find("one")->value);
+  ASSERT_EQ(4, tree.Find("four")->value);
+}
+TEST(BinarySearchTreeNonFixture, EmplaceKeepsExistingValue) {
+  BinarySearchTree<std::string, std::unique_ptr<int>> tree;
+  auto result = tree.Emplace("key", std::make_unique<int>(1));
+  ASSERT_TRUE(result.second);
+  result = tree.Emplace("key", std::make_unique<int>(2));
+  ASSERT_FALSE(result.second);
+  ASSERT_EQ(1, *result.first->second);
+  result = tree.TryEmplace("key", std::make_unique<int>(3));
+  ASSERT_FALSE(result.second);
+  ASSERT_EQ(1, **tree.Find("key"));
+  result = tree.TryEmplace("other", std::make_unique<int>(4));
+  ASSERT_TRUE(result.second);
+  ASSERT_EQ("other", result.first->first);
+  ASSERT_EQ(2, tree.GetSize());
+}
+TEST_F(BinarySearchTreeFixture, MoveConstructorAndAssignment) {
+  BinarySearchTree<std::string, int> moved(std::move(test_tree));
+  ASSERT_EQ(6, moved.GetSize());
+  ASSERT_TRUE(test_tree.IsEmpty());
+  ASSERT_EQ(5, *moved.Find("five"));
+  BinarySearchTree<std::string, int> assigned;
+  assigned.Insert("old", 1);
+  assigned = std::move(moved);
+  ASSERT_EQ(6, assigned.GetSize());
+  ASSERT_EQ(nullptr, assigned.Find("old"));
+  ASSERT_TRUE(moved.IsEmpty());
+}
+TEST_F(BinarySearchTreeFixture, HeterogeneousLookup) {
+  std::string_view text = "five four";
+  ASSERT_EQ(5, *test_tree.Find(text.substr(0, 4)));
+  ASSERT_TRUE(test_tree.Contains(text.substr(5)));
+  ASSERT_FALSE(test_tree.Contains(text));
+  ASSERT_EQ("nine", test_tree.upper_bound(text.substr(5))->first);
+  ASSERT_TRUE(test_tree.Erase(text.substr(0, 4)));
+  ASSERT_FALSE(test_tree.Contains(std::string("five")));
+  ASSERT_EQ(5, test_tree.GetSize());
+}
+TEST(BinarySearchTreeNonFixture, CustomComparator) {
+  BinarySearchTree<std::string, int, AvlBalancing, HeapNodeAllocation,
+                   std::greater<std::string>>
+      tree;
+  tree.Insert("a", 1);
+  tree.Insert("c", 3);
+  tree.Insert("b", 2);
+  std::vector<std::string> keys;
+  for (const auto &pair : tree) {
+    keys.push_back(pair.first);
+  }
+  std::vector<std::string> expected = {"c", "b", "a"};
+  ASSERT_EQ(keys, expected);
+  ASSERT_EQ(2, *tree.Find("b"));
+  ASSERT_TRUE(tree.Contains("a"));
+  ASSERT_TRUE(tree.Erase("a"));
+}
+TEST(BinarySearchTreeNonFixture, AssignSortedBuildsOptimalHeight) {
+  std::vector<std::pair<int, int>> items;
+  for (int i = 0; i < 1000; ++i) {
+    items.push_back({i, i * 10});
+  }
+  BinarySearchTree<int, int> tree;
+  tree.Insert(5000, 1);
+  tree.AssignSorted(items.begin(), items.end());
+  ASSERT_EQ(1000, tree.GetSize());
+  ASSERT_EQ(10, tree.GetHeight());
+  ASSERT_EQ(nullptr, tree.Find(5000));
+  ASSERT_EQ(990, *tree.Find(99));
+  tree.Insert(1000, 1);
+  tree.Erase(0);
+  ASSERT_EQ(1000, tree.GetSize());
+  ASSERT_LE(tree.GetHeight(), 11);
+}
+TEST(BinarySearchTreeNonFixture, AssignSortedLastDuplicateWins) {
+  std::vector<std::pair<std::string, int>> items = {
+      {"a", 1}, {"b", 2}, {"b", 3}, {"c", 4}, {"c", 5}, {"c", 6}};
+  BinarySearchTree<std::string, int> tree;
+  tree.AssignSorted(std::make_move_iterator(items.begin()),
+                    std::make_move_iterator(items.end()));
+  ASSERT_EQ(3, tree.GetSize());
+  ASSERT_EQ(3, *tree.Find("b"));
+  ASSERT_EQ(6, *tree.Find("c"));
+  std::vector<std::pair<std::string, int>> unsorted = {{"b", 1}, {"a", 2}};
+  ASSERT_THROW(tree.AssignSorted(unsorted.begin(), unsorted.end()),
+               std::invalid_argument);
+  ASSERT_EQ(3, tree.GetSize());
+}
+TEST(BinarySearchTreeNonFixture, AssignSortsAndEqualsIncrementalTree) {
+  std::vector<std::pair<std::string, int>> items = {
+      {"six", 6}, {"five", 5}, {"nine", 0}, {"four", 4}, {"nine", 9}};
+  BinarySearchTree<std::string, int> incremental;
+  for (const auto &item : items) {
+    incremental.Insert(item.first, item.second);
+  }
+  BinarySearchTree<std::string, int> built;
+  built.Assign(std::move(items));
+  ASSERT_EQ(4, built.GetSize());
+  ASSERT_EQ(9, *built.Find("nine"));
+  ASSERT_TRUE(built == incremental);
+}
+TEST(BinarySearchTreeNonFixture, OrderStatisticsMatchSortedKeys) {
+  BinarySearchTree<int, int, AvlBalancing, PoolNodeAllocation, std::less<>,
+                   OrderStatistics>
+      tree;
+  std::map<int, int> expected;
+  std::mt19937 generator(3);
+  std::uniform_int_distribution<int> key_distribution(0, 600);
+  for (int i = 0; i < 6000; ++i) {
+    int key = key_distribution(generator);
+    if (generator() % 3 == 0) {
+      ASSERT_EQ(expected.erase(key) == 1, tree.Erase(key));
+    } else {
+      tree.Emplace(key, i);
+      expected.emplace(key, i);
+    }
+  }
+  std::vector<int> keys;
+  for (const auto &pair : expected) {
+    keys.push_back(pair.first);
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(keys[i], tree.Select(i)->first);
+    ASSERT_EQ(i, tree.Rank(keys[i]));
+  }
+  ASSERT_EQ(tree.end(), tree.Select(keys.size()));
+  for (int first = -1; first <= 601; first += 37) {
+    for (int last = first - 5; last <= 601; last += 53) {
+      size_t count = last < first
+                         ? 0
+                         : std::distance(expected.lower_bound(first),
+                                         expected.upper_bound(last));
+      ASSERT_EQ(count, tree.CountRange(first, last));
+    }
+  }
+  auto copy = tree;
+  copy.AssignSorted(expected.begin(), expected.end());
+  ASSERT_EQ(keys.size() / 2, copy.Rank(keys[keys.size() / 2]));
+}
+TEST(BinarySearchTreeNonFixture, OrderStatisticsWithoutBalancing) {
+  BinarySearchTree<std::string, int, NoBalancing, HeapNodeAllocation,
+                   std::less<>, OrderStatistics>
+      tree;
+  for (const char *word : {"mine", "apple", "test", "craft", "food"}) {
+    tree.Insert(word, 0);
+  }
+  tree.Erase("mine");
+  ASSERT_EQ("food", tree.Select(2)->first);
+  ASSERT_EQ(2, tree.Rank(std::string_view("dog")));
+  ASSERT_EQ(3, tree.CountRange(std::string_view("b"), std::string_view("z")));
+}
+TEST(BinarySearchTreeNonFixture, SplitAndJoinKeepOrderAndBalance) {
+  using Tree = BinarySearchTree<int, int, AvlBalancing, PoolNodeAllocation,
+                                std::less<>, OrderStatistics>;
+  Tree tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.Insert(i * 2, i);
+  }
+  Tree right = tree.Split(700);
+  ASSERT_EQ(350, tree.GetSize());
+  ASSERT_EQ(650, right.GetSize());
+  ASSERT_EQ(698, (--tree.end())->first);
+  ASSERT_EQ(700, right.begin()->first);
+  ASSERT_EQ(100, right.Rank(900));
+  ASSERT_LE(right.GetHeight(), 1.45 * std::log2(right.GetSize() + 2));
+  Tree middle = right.Split(1001);
+  ASSERT_EQ(151, right.GetSize());
+  ASSERT_THROW(middle.Join(std::move(right)), std::invalid_argument);
+  ASSERT_EQ(151, right.GetSize());
+  // Destroying the tree first checks that split trees share slabs safely
+  tree.Join(std::move(right));
+  {
+    Tree temporary = std::move(tree);
+    tree.Insert(-1, -1);
+    tree.Join(std::move(temporary));
+  }
+  tree.Join(std::move(middle));
+  ASSERT_TRUE(middle.IsEmpty());
+  ASSERT_EQ(1001, tree.GetSize());
+  ASSERT_LE(tree.GetHeight(), 1.45 * std::log2(tree.GetSize() + 2));
+  int expected_key = -1;
+  size_t rank = 0;
+  for (const auto &pair : tree) {
+    ASSERT_EQ(expected_key, pair.first);
+    ASSERT_EQ(rank++, tree.Rank(pair.first));
+    expected_key = pair.first < 0 ? 0 : pair.first + 2;
+  }
+}
+TEST(BinarySearchTreeNonFixture, SetOperationsMatchStdMap) {
+  using Tree = BinarySearchTree<int, int, AvlBalancing, PoolNodeAllocation>;
+  std::mt19937 generator(11);
+  for (int sizes : {0, 1, 2, 3}) {
+    size_t first_size = sizes % 2 ? 3000 : 20;
+    size_t second_size = sizes / 2 ? 3000 : 20;
+    std::uniform_int_distribution<int> key_distribution(0, 5000);
+    Tree first, second;
+    std::map<int, int> first_map, second_map;
+    while (first_map.size() < first_size) {
+      int key = key_distribution(generator);
+      first.Insert(key, 1);
+      first_map[key] = 1;
+    }
+    while (second_map.size() < second_size) {
+      int key = key_distribution(generator);
+      second.Insert(key, 2);
+      second_map[key] = 2;
+    }
+    Tree united = first;
+    united.Union(second);
+    std::map<int, int> expected = first_map;
+    for (const auto &pair : second_map) {
+      expected[pair.first] = pair.second;
+    }
+    ASSERT_EQ(expected.size(), united.GetSize());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), united.begin()));
+    ASSERT_LE(united.GetHeight(), 1.45 * std::log2(united.GetSize() + 2));
+
+    Tree intersected = first;
+    intersected.Intersection(second);
+    expected.clear();
+    for (const auto &pair : first_map) {
+      if (second_map.count(pair.first))
+        expected.insert(pair);
+    }
+    ASSERT_EQ(expected.size(), intersected.GetSize());
+    ASSERT_TRUE(
+        std::equal(expected.begin(), expected.end(), intersected.begin()));
+
+    Tree subtracted = first;
+    subtracted.Difference(second);
+    expected.clear();
+    for (const auto &pair : first_map) {
+      if (!second_map.count(pair.first))
+        expected.insert(pair);
+    }
+    ASSERT_EQ(expected.size(), subtracted.GetSize());
+    ASSERT_TRUE(
+        std::equal(expected.begin(), expected.end(), subtracted.begin()));
+    ASSERT_LE(subtracted.GetHeight(),
+              1.45 * std::log2(subtracted.GetSize() + 2));
+  }
+}
+TEST(BinarySearchTreeNonFixture, UnionResolverAndNoBalancing) {
+  BinarySearchTree<std::string, int, NoBalancing> first, second;
+  first.Insert("apple", 1);
+  first.Insert("food", 1);
+  second.Insert("food", 10);
+  second.Insert("mine", 10);
+  first.Union(second, [](int &value, const int &other) { value += other; });
+  ASSERT_EQ(3, first.GetSize());
+  ASSERT_EQ(11, *first.Find("food"));
+  ASSERT_EQ(10, *first.Find("mine"));
+  const int *food = first.Find("food");
+  std::vector<std::string> added;
+  second.Insert("zoo", 10);
+  first.Union(
+      second, [](int &, const int &) {},
+      [&added](std::pair<const std::string, int> &pair) {
+        added.push_back(pair.first);
+      });
+  ASSERT_EQ(std::vector<std::string>{"zoo"}, added);
+  ASSERT_EQ(food, first.Find("food"));
+  first.Difference(first);
+  ASSERT_TRUE(first.IsEmpty());
+}
+TEST(BinarySearchTreeNonFixture, DeepTreeNeedsNoRecursion) {
+  // Joining trees without balancing stacks them into a chain of left
+  // children, deep enough to overflow the stack of recursive helpers
+  const int depth = 1 << 20;
+  BinarySearchTree<int, int, NoBalancing> chain;
+  for (int i = 0; i < depth; ++i) {
+    BinarySearchTree<int, int, NoBalancing> single;
+    single.Insert(i, i);
+    chain.Join(std::move(single));
+  }
+  ASSERT_EQ(depth, chain.GetSize());
+  ASSERT_EQ(depth, chain.GetHeight());
+  BinarySearchTree<int, int, NoBalancing> copy = chain;
+  ASSERT_EQ(depth, copy.GetHeight());
+  ASSERT_TRUE(copy == chain);
+  long long sum = 0;
+  copy.InOrderTraversal(
+      [&sum](const int &key, const int &value) { sum += key + value; });
+  ASSERT_EQ(static_cast<long long>(depth) * (depth - 1), sum);
+  BinarySearchTree<int, int, NoBalancing> right = copy.Split(depth / 2);
+  ASSERT_EQ(depth / 2, copy.GetSize());
+  ASSERT_EQ(depth / 2, right.begin()->first);
+  copy.Clear();
+  ASSERT_TRUE(copy.IsEmpty());
+  // Set operations descend the chain as the other tree and as this one
+  BinarySearchTree<int, int, NoBalancing> merged;
+  merged.Insert(-1, -1);
+  merged.Insert(depth / 2, 0);
+  merged.Union(chain);
+  ASSERT_EQ(depth + 1, merged.GetSize());
+  ASSERT_EQ(depth / 2, merged[depth / 2]);
+  merged.Intersection(chain);
+  ASSERT_EQ(depth, merged.GetSize());
+  ASSERT_TRUE(merged == chain);
+  merged.Difference(chain);
+  ASSERT_TRUE(merged.IsEmpty());
+  BinarySearchTree<int, int, NoBalancing> ends;
+  ends.Insert(0, 0);
+  ends.Insert(depth - 1, depth - 1);
+  BinarySearchTree<int, int, NoBalancing> rest = chain;
+  rest.Difference(ends);
+  ASSERT_EQ(depth - 2, rest.GetSize());
+  ASSERT_EQ(1, rest.begin()->first);
+  rest.Union(ends);
+  ASSERT_TRUE(rest == chain);
+  rest.Intersection(ends);
+  ASSERT_EQ(2, rest.GetSize());
+}
+TEST(BinarySearchTreeNonFixture, DiffReportsChangesInKeyOrder) {
+  BinarySearchTree<int, int> first, second;
+  for (int key : {5, 1, 9, 3, 7}) {
+    first.Insert(key, key);
+  }
+  for (int key : {3, 9, 4, 7}) {
+    second.Insert(key, key == 7 ? 70 : key);
+  }
+  std::vector<std::string> events;
+  first.Diff(
+      second,
+      [&](const int &key, const int &value) {
+        events.push_back("+" + std::to_string(key) + "=" +
+                         std::to_string(value));
+      },
+      [&](const int &key, const int &) {
+        events.push_back("-" + std::to_string(key));
+      },
+      [&](const int &key, const int &old_value, const int &new_value) {
+        events.push_back("~" + std::to_string(key) + ":" +
+                         std::to_string(old_value) + "->" +
+                         std::to_string(new_value));
+      });
+  std::vector<std::string> expected = {"-1", "+4=4", "-5", "~7:7->70"};
+  ASSERT_EQ(expected, events);
+  int calls = 0;
+  auto count = [&calls](const auto &...) { ++calls; };
+  first.Diff(first, count, count, count);
+  second.Diff(BinarySearchTree<int, int>(second), count, count, count);
+  ASSERT_EQ(0, calls);
+}
+TEST(BinarySearchTreeNonFixture, StatisticsCountComparisonsAndDepths) {
+  BinarySearchTree<int, int, NoBalancing, HeapNodeAllocation, std::less<>,
+                   NoOrderStatistics, CollectStatistics>
+      chain;
+  for (int i = 1; i <= 5; ++i) {
+    chain.Insert(i, i);
+  }
+  TreeStatistics statistics = chain.GetStatistics();
+  ASSERT_EQ(5, statistics.size);
+  ASSERT_EQ(5, statistics.max_depth);
+  ASSERT_DOUBLE_EQ(3.0, statistics.average_depth);
+  ASSERT_EQ(std::vector<size_t>(5, 1), statistics.depth_histogram);
+  ASSERT_EQ(5 * statistics.node_size, statistics.node_bytes);
+  // Every node passed on the way costs two comparisons
+  ASSERT_EQ(5, statistics.insert_calls);
+  ASSERT_EQ(20, statistics.insert_comparisons);
+  chain.ResetStatistics();
+  ASSERT_NE(nullptr, chain.Find(5));
+  ASSERT_TRUE(chain.Contains(1));
+  statistics = chain.GetStatistics();
+  ASSERT_EQ(2, statistics.find_calls);
+  ASSERT_EQ(12, statistics.find_comparisons);
+  ASSERT_EQ(0, statistics.insert_calls);
+
+  BinarySearchTree<int, int> balanced;
+  for (int i = 1; i <= 7; ++i) {
+    balanced.Insert(i, i);
+  }
+  balanced.Find(7);
+  statistics = balanced.GetStatistics();
+  ASSERT_EQ(std::vector<size_t>({1, 2, 4}), statistics.depth_histogram);
+  ASSERT_DOUBLE_EQ(17.0 / 7, statistics.average_depth);
+  ASSERT_EQ(0, statistics.find_calls);
+  ASSERT_LT(sizeof(balanced), sizeof(chain));
+}
+TEST(BinarySearchTreeNonFixture, MemoryResourceHoldsNodesAndStrings) {
+  using Tree = BinarySearchTree<std::pmr::string, std::pmr::string,
+                                AvlBalancing, PoolNodeAllocation>;
+  std::vector<std::byte> buffer(1 << 20);
+  std::pmr::monotonic_buffer_resource arena(
+      buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  // Anything allocated outside the arena throws std::bad_alloc. The
+  // default is restored even if an assertion returns early
+  DefaultResourceGuard null_default(std::pmr::null_memory_resource());
+  {
+    Tree tree(&arena);
+    for (int i = 0; i < 200; ++i) {
+      std::pmr::string key(20, 'a' + i % 26, &arena);
+      key += std::to_string(i);
+      tree.Insert(std::move(key), std::pmr::string(30, 'z', &arena));
+    }
+    tree.TryEmplace(std::pmr::string(40, 'k', &arena),
+                    "emplaced value longer than sso");
+    ASSERT_TRUE(tree.Erase(std::string_view(std::string(20, 'a') + "0")));
+    Tree copy = tree;
+    ASSERT_EQ(&arena, copy.GetMemoryResource());
+    Tree right = copy.Split(std::string_view("n"));
+    ASSERT_EQ(&arena, right.GetMemoryResource());
+    right.Insert(std::pmr::string(25, 'x', &arena),
+                 std::pmr::string(25, 'y', &arena));
+    copy.Join(std::move(right));
+    ASSERT_EQ(201, copy.GetSize());
+    ASSERT_EQ(&arena, copy.begin()->second.get_allocator().resource());
+  }
+}
+TEST(BinarySearchTreeNonFixture, SplayMovesAccessedKeysToRoot) {
+  BinarySearchTree<int, int, SplayBalancing, PoolNodeAllocation, std::less<>,
+                   OrderStatistics, CollectStatistics>
+      tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.Insert(i, i);
+  }
+  // Sorted insertions leave a chain, the first lookup at its bottom
+  // roughly halves the depth of the whole path
+  ASSERT_EQ(1000, tree.GetHeight());
+  ASSERT_EQ(0, *std::as_const(tree).Find(0));
+  ASSERT_LT(tree.GetHeight(), 600);
+  tree.ResetStatistics();
+  ASSERT_TRUE(tree.Contains(0));
+  ASSERT_EQ(2, tree.GetStatistics().find_comparisons);
+  // A miss splays the last node on its path
+  ASSERT_EQ(nullptr, tree.Find(1000));
+  tree.ResetStatistics();
+  ASSERT_TRUE(tree.Contains(999));
+  ASSERT_EQ(2, tree.GetStatistics().find_comparisons);
+
+  std::map<int, int> expected;
+  for (int i = 0; i < 1000; ++i) {
+    expected[i] = i;
+  }
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> key_distribution(0, 2000);
+  for (int i = 0; i < 20000; ++i) {
+    int key = key_distribution(generator);
+    switch (generator() % 4) {
+    case 0:
+      ASSERT_EQ(expected.erase(key) == 1, tree.Erase(key));
+      break;
+    case 1:
+      ASSERT_EQ(expected.count(key) == 1, tree.Contains(key));
+      break;
+    case 2:
+      tree[key] += i;
+      expected[key] += i;
+      break;
+    default:
+      ASSERT_EQ(expected.insert_or_assign(key, i).second, tree.Insert(key, i));
+    }
+  }
+  ASSERT_EQ(expected.size(), tree.GetSize());
+  ASSERT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin(),
+                         expected.end()));
+  ASSERT_EQ(expected.size() / 2, tree.Rank(std::next(expected.begin(),
+                                                     expected.size() / 2)
+                                               ->first));
+}
+TEST(BinarySearchTreeNonFixture, FindBatchMatchesFind) {
+  BinarySearchTree<std::string, int, AvlBalancing, PoolNodeAllocation,
+                   std::less<>, NoOrderStatistics, CollectStatistics>
+      tree;
+  BinarySearchTree<std::string, int, SplayBalancing> splay;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 1000; ++i) {
+    keys.push_back(std::to_string(i * 7919 % 1000));
+    if (i % 3 != 0) {
+      tree.Insert(keys.back(), i);
+      splay.Insert(keys.back(), i);
+    }
+  }
+  keys.push_back("");
+  keys.push_back("not a number");
+  std::vector<std::string_view> views(keys.begin(), keys.end());
+  // Misses must be reported as nullptr, not left untouched
+  int sentinel = -1;
+  // Odd sizes leave some of the interleaved searches without keys
+  for (size_t count : {size_t{0}, size_t{1}, size_t{5}, keys.size()}) {
+    std::vector<const int *> results(count, &sentinel);
+    tree.ResetStatistics();
+    tree.FindBatch(views.data(), count, results.data());
+    ASSERT_EQ(count, tree.GetStatistics().find_calls);
+    for (size_t index = 0; index < count; ++index) {
+      ASSERT_EQ(tree.Find(keys[index]), results[index]);
+    }
+    results.assign(count, &sentinel);
+    splay.FindBatch(keys.data(), count, results.data());
+    for (size_t index = 0; index < count; ++index) {
+      ASSERT_EQ(splay.Find(keys[index]), results[index]);
+    }
+  }
+  BinarySearchTree<std::string, int> empty;
+  const int *result = &sentinel;
+  empty.FindBatch(keys.data(), 1, &result);
+  ASSERT_EQ(nullptr, result);
+}
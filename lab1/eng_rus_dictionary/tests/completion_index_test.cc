@@ -0,0 +1,129 @@
+//
+//  completion_index_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 24/11/2025.
+//
+
+#include "../src/completion_index/completion_index.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Positions of the count heaviest elements of [first, last) by
+ * sorting, ties by position.
+ */
+std::vector<size_t> SortedTopK(const std::vector<uint64_t> &weights,
+                               size_t first, size_t last, size_t count) {
+  std::vector<size_t> positions;
+  for (size_t position = first; position < last; ++position)
+    positions.push_back(position);
+  std::stable_sort(positions.begin(), positions.end(),
+                   [&weights](size_t position, size_t other) {
+                     return weights[position] > weights[other];
+                   });
+  positions.resize(std::min(count, positions.size()));
+  return positions;
+}
+
+} // namespace
+
+TEST(CompletionIndexTest, TopKOrdersByWeightThenPosition) {
+  std::vector<int> elements{0, 1, 2, 3, 4};
+  std::vector<uint64_t> weights{5, 9, 5, 0, 9};
+  CompletionIndex<int> index;
+  index.Assign(elements.begin(), elements.end(),
+               [&weights](const int &element) { return weights[element]; });
+  ASSERT_EQ(5, index.GetSize());
+  std::vector<int> visited;
+  auto visit = [&visited](const int &element) { visited.push_back(element); };
+  index.TopK(0, 5, 10, visit);
+  ASSERT_EQ((std::vector<int>{1, 4, 0, 2, 3}), visited);
+  visited.clear();
+  index.TopK(2, 4, 1, visit);
+  ASSERT_EQ(std::vector<int>{2}, visited);
+  visited.clear();
+  index.SetWeight(3, 10);
+  ASSERT_EQ(10, index.GetWeight(3));
+  index.TopK(0, 5, 2, visit);
+  ASSERT_EQ((std::vector<int>{3, 1}), visited);
+  visited.clear();
+  index.TopK(3, 3, 2, visit);
+  index.TopK(0, 5, 0, visit);
+  ASSERT_TRUE(visited.empty());
+}
+TEST(CompletionIndexTest, EmptyAndSingleElement) {
+  std::list<int> elements;
+  CompletionIndex<int> index;
+  index.Assign(elements.begin(), elements.end(),
+               [](const int &) { return uint64_t{1}; });
+  ASSERT_EQ(0, index.GetSize());
+  elements.push_back(7);
+  index.Assign(elements.begin(), elements.end(),
+               [](const int &) { return uint64_t{1}; });
+  std::vector<const int *> visited;
+  index.TopK(0, 1, 3,
+             [&visited](const int &element) { visited.push_back(&element); });
+  ASSERT_EQ(std::vector<const int *>{&elements.front()}, visited);
+  index.Clear();
+  ASSERT_EQ(0, index.GetSize());
+}
+TEST(CompletionIndexTest, MoveTakesArraysAndResource) {
+  static_assert(std::is_nothrow_move_assignable_v<CompletionIndex<int>>);
+  std::vector<int> elements{0, 1, 2, 3};
+  auto weight_of = [](const int &element) { return uint64_t(element); };
+  std::pmr::monotonic_buffer_resource arena;
+  CompletionIndex<int> source(&arena);
+  source.Assign(elements.begin(), elements.begin() + 2, weight_of);
+  // Anything allocated by target's own resource throws std::bad_alloc
+  CompletionIndex<int> target(std::pmr::null_memory_resource());
+  target = std::move(source);
+  ASSERT_EQ(2, target.GetSize());
+  ASSERT_EQ(0, source.GetSize());
+  target.Assign(elements.begin(), elements.end(), weight_of);
+  std::vector<int> visited;
+  target.TopK(0, 4, 1,
+              [&visited](const int &element) { visited.push_back(element); });
+  ASSERT_EQ(std::vector<int>{3}, visited);
+}
+TEST(CompletionIndexTest, RandomQueriesMatchSorting) {
+  std::mt19937 generator(42);
+  for (size_t size : {2, 3, 7, 64, 100, 1000}) {
+    std::vector<size_t> elements(size);
+    std::vector<uint64_t> weights(size);
+    for (size_t position = 0; position < size; ++position) {
+      elements[position] = position;
+      weights[position] = generator() % 8;
+    }
+    CompletionIndex<size_t> index;
+    index.Assign(elements.begin(), elements.end(),
+                 [&weights](const size_t &element) {
+                   return weights[element];
+                 });
+    for (size_t query = 0; query < 200; ++query) {
+      if (query % 4 == 0) {
+        size_t position = generator() % size;
+        weights[position] = generator() % 8;
+        index.SetWeight(position, weights[position]);
+      }
+      size_t first = generator() % size;
+      size_t last = first + 1 + generator() % (size - first);
+      size_t count = generator() % 12;
+      std::vector<size_t> visited;
+      index.TopK(first, last, count, [&visited](const size_t &element) {
+        visited.push_back(element);
+      });
+      ASSERT_EQ(SortedTopK(weights, first, last, count), visited)
+          << size << " elements, [" << first << ", " << last << ")";
+    }
+  }
+}
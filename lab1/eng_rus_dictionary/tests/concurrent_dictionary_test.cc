@@ -0,0 +1,79 @@
+//
+//  concurrent_dictionary_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 15/11/2025.
+//
+
+#include "../src/concurrent_dictionary/concurrent_dictionary.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentDictionaryTest, SingleThreadOperations) {
+  ConcurrentDictionary dict;
+  ASSERT_TRUE(dict.IsEmpty());
+  dict += "hello:привет";
+  dict += std::make_pair(std::string("world"), std::string("мир"));
+  dict += "hello:здравствуй";
+  ASSERT_EQ(dict.GetSize(), 2);
+  ASSERT_EQ(dict["hello"], "здравствуй");
+  ASSERT_EQ(dict.Find("world"), std::string("мир"));
+  ASSERT_FALSE(dict.Find("apple").has_value());
+  ASSERT_THROW(dict["apple"], std::out_of_range);
+  ASSERT_THROW(dict["яблоко"], std::invalid_argument);
+  ASSERT_THROW(dict += "apple:apple", std::invalid_argument);
+  ASSERT_THROW(dict -= "apple", std::out_of_range);
+  ConcurrentDictionary::Version snapshot = dict.Snapshot();
+  dict -= "hello";
+  ASSERT_FALSE(dict.Contains("hello"));
+  ASSERT_TRUE(snapshot.Contains("hello"));
+  std::ostringstream out;
+  out << dict;
+  ASSERT_EQ(out.str(), "world:мир\n");
+}
+
+TEST(ConcurrentDictionaryTest, ReadersDuringWrites) {
+  ConcurrentDictionary dict;
+  const int stable_words = 200;
+  auto StableWord = [](int i) {
+    return "stable" + std::string(1, 'a' + i % 26) +
+           std::string(1, 'a' + i / 26);
+  };
+  for (int i = 0; i < stable_words; ++i)
+    dict += StableWord(i) + ":слово";
+
+  std::atomic<bool> stop{false};
+  std::atomic<int> failures{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&, t] {
+      int i = t;
+      while (!stop.load()) {
+        std::optional<std::string> found = dict.Find(StableWord(i));
+        if (!found || *found != "слово")
+          ++failures;
+        std::optional<std::string> churn = dict.Find("churn");
+        if (churn && *churn != "один" && *churn != "два")
+          ++failures;
+        size_t size = dict.GetSize();
+        if (size < stable_words || size > stable_words + 1)
+          ++failures;
+        i = (i + 7) % stable_words;
+      }
+    });
+  }
+  for (int step = 0; step < 500; ++step) {
+    dict += step % 2 ? "churn:один" : "churn:два";
+    if (step % 3 == 0)
+      dict -= "churn";
+  }
+  stop = true;
+  for (std::thread &reader : readers)
+    reader.join();
+  ASSERT_EQ(failures.load(), 0);
+  ASSERT_EQ(dict.GetSize(), stable_words + 1);
+}
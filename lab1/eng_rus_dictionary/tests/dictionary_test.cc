@@ -6,12 +6,52 @@
 //
 
 #include "../src/dictionary/dictionary.h"
+#include "temp_path.h"
+#include <algorithm>
+#include <cstddef>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #define DICTIONARY_INPUT_FILE_PATH "input/input_dictionary.txt"
 #define DICTIONARY_INPUT_EMPTY_FILE_PATH "input/input_dictionary_empty.txt"
+#define DICTIONARY_INPUT_DUPLICATES_FILE_PATH                                 \
+  "input/input_dictionary_duplicates.txt"
 #define DICTIONARY_OUTPUT_FILE_PATH "output/output_dictionary.txt"
 
+namespace {
+
+/**
+ * @brief Memory resource counting allocations made through it.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+  size_t GetAllocations() const { return allocations_; }
+
+private:
+  size_t allocations_ = 0; ///< Number of allocate calls
+
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations_;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *pointer, size_t bytes, size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+} // namespace
+
 class DictionaryFixture : public ::testing::Test {
 protected:
   void SetUp() override {
@@ -311,6 +351,13 @@ TEST_F(DictionaryFixture, LoadFromFileNonEmptyFile) {
   ASSERT_TRUE(dict == test_dict);
 }
 
+TEST(DictionaryNonFixture, LoadFromFileMissingFile) {
+  Dictionary dict;
+  dict += "word:слово";
+  ASSERT_FALSE(dict.LoadFromFile("input/no_such_dictionary.txt"));
+  ASSERT_TRUE(dict.Contains("word"));
+}
+
 TEST(DictionaryNonFixture, LoadFromFileEmptyFile) {
   Dictionary dict;
   ASSERT_TRUE(dict.LoadFromFile(DICTIONARY_INPUT_EMPTY_FILE_PATH));
@@ -323,3 +370,421 @@ TEST(DictionaryNonFixture, LoadFromFileEmptyFile) {
   empty_file.close();
   ASSERT_TRUE(dict.IsEmpty());
 }
+TEST_F(DictionaryFixture, IteratorsWalkAlphabetically) {
+  std::vector<std::string> words;
+  for (const auto &word_pair : test_dict) {
+    words.emplace_back(word_pair.first);
+  }
+  std::vector<std::string> expected = {"Object-Oriented-Programming",
+                                       "apple",
+                                       "craft",
+                                       "food",
+                                       "mine",
+                                       "mushroom",
+                                       "programmer",
+                                       "test"};
+  ASSERT_EQ(words, expected);
+}
+TEST_F(DictionaryFixture, FindRangeInclusiveBounds) {
+  auto range = test_dict.FindRange("craft", "mine");
+  std::vector<std::string> words;
+  for (auto it = range.first; it != range.second; ++it) {
+    words.emplace_back(it->first);
+  }
+  std::vector<std::string> expected = {"craft", "food", "mine"};
+  ASSERT_EQ(words, expected);
+  range = test_dict.FindRange("mine", "craft");
+  ASSERT_TRUE(range.first == range.second);
+  ASSERT_THROW(test_dict.FindRange("a", "яблоко"), std::invalid_argument);
+}
+TEST_F(DictionaryFixture, FindPrefix) {
+  test_dict += "application:приложение";
+  auto range = test_dict.FindPrefix("app");
+  std::vector<std::string> words;
+  for (auto it = range.first; it != range.second; ++it) {
+    words.emplace_back(it->first);
+  }
+  std::vector<std::string> expected = {"apple", "application"};
+  ASSERT_EQ(words, expected);
+  range = test_dict.FindPrefix("zebra");
+  ASSERT_TRUE(range.first == range.second);
+  range = test_dict.FindPrefix("");
+  ASSERT_EQ(test_dict.GetSize(),
+            static_cast<size_t>(std::distance(range.first, range.second)));
+  ASSERT_THROW(test_dict.FindPrefix("при"), std::invalid_argument);
+}
+TEST_F(DictionaryFixture, MoveConstructorAndAssignment) {
+  Dictionary moved(std::move(test_dict));
+  ASSERT_EQ(moved.GetSize(), 8);
+  ASSERT_TRUE(test_dict.IsEmpty());
+  Dictionary assigned;
+  assigned += "hello:привет";
+  assigned = std::move(moved);
+  ASSERT_EQ(assigned.GetSize(), 8);
+  ASSERT_EQ(assigned["mine"], "добывать");
+  ASSERT_TRUE(moved.IsEmpty());
+}
+TEST(DictionaryNonFixture, AddOperatorMovedPair) {
+  Dictionary dict;
+  std::pair<std::string, std::string> word_pair("hello", "привет");
+  dict += std::move(word_pair);
+  ASSERT_EQ(dict["hello"], "привет");
+  ASSERT_THROW(dict += std::make_pair(std::string("привет"),
+                                      std::string("hello")),
+               std::invalid_argument);
+}
+TEST_F(DictionaryFixture, StringViewLookup) {
+  std::string_view text = "apple food zebra";
+  ASSERT_EQ(*test_dict.Find(text.substr(0, 5)), "яблоко");
+  ASSERT_EQ(test_dict.Find(text.substr(11)), nullptr);
+  ASSERT_TRUE(test_dict.Contains(text.substr(6, 4)));
+  const Dictionary &const_dict = test_dict;
+  ASSERT_EQ(const_dict[text.substr(6, 4)], "еда");
+  ASSERT_THROW(const_dict[text.substr(11)], std::out_of_range);
+  test_dict -= text.substr(6, 4);
+  ASSERT_FALSE(test_dict.Contains("food"));
+  ASSERT_THROW(test_dict -= text.substr(6, 4), std::out_of_range);
+}
+TEST(DictionaryNonFixture, LoadFromFileLastDuplicateWins) {
+  Dictionary dict;
+  dict += "old:старый";
+  ASSERT_TRUE(dict.LoadFromFile(DICTIONARY_INPUT_DUPLICATES_FILE_PATH));
+  ASSERT_EQ(dict.GetSize(), 3);
+  ASSERT_EQ(dict["hello"], "здравствуй");
+  ASSERT_EQ(dict["world"], "мир");
+  ASSERT_FALSE(dict.Contains("old"));
+}
+TEST(DictionaryNonFixture, ParallelLoadMatchesSequentialRead) {
+  // Several hundred kilobytes, so that the file is cut into many parts,
+  // with words repeated across parts and invalid lines
+  TempPath temp("parallel_load_test.txt");
+  const std::string &path = temp.Get();
+  {
+    const char *translations[] = {"один", "два", "три", "четыре"};
+    std::mt19937 generator(5);
+    std::ofstream file(path);
+    for (size_t line = 0; line < 80000; ++line) {
+      std::string word(1 + generator() % 3, 'a');
+      for (char &letter : word)
+        letter = static_cast<char>('a' + generator() % 26);
+      if (line % 97 == 0)
+        file << "bad line\n";
+      file << word << ":" << translations[generator() % 4] << "\n";
+    }
+  }
+  Dictionary expected;
+  std::ifstream file(path);
+  file >> expected;
+  for (size_t thread_count : {1, 2, 3, 8, 0}) {
+    Dictionary dict;
+    ASSERT_TRUE(dict.LoadFromFile(path, thread_count));
+    ASSERT_TRUE(dict == expected) << thread_count << " threads";
+  }
+}
+TEST_F(DictionaryFixture, SelectRankAndCountRange) {
+  ASSERT_EQ(test_dict.Select(0)->first, "Object-Oriented-Programming");
+  ASSERT_EQ(test_dict.Select(3)->first, "food");
+  ASSERT_TRUE(test_dict.Select(8) == test_dict.end());
+  ASSERT_EQ(test_dict.Rank("food"), 3);
+  ASSERT_EQ(test_dict.Rank("zebra"), 8);
+  ASSERT_EQ(test_dict.CountRange("craft", "mine"), 3);
+  ASSERT_EQ(test_dict.CountRange("mine", "craft"), 0);
+  test_dict -= "food";
+  ASSERT_EQ(test_dict.CountRange("craft", "mine"), 2);
+  ASSERT_EQ(test_dict.Select(3)->first, "mine");
+  ASSERT_THROW(test_dict.Rank("еда"), std::invalid_argument);
+  ASSERT_THROW(test_dict.CountRange("a", "яблоко"), std::invalid_argument);
+}
+TEST_F(DictionaryFixture, MergePolicies) {
+  Dictionary glossary;
+  glossary += "food:пища";
+  glossary += "zebra:зебра";
+  glossary += "bread:хлеб";
+  Dictionary kept = test_dict;
+  kept.Merge(glossary, Dictionary::MergePolicy::kKeepExisting);
+  ASSERT_EQ(kept.GetSize(), 10);
+  ASSERT_EQ(kept["food"], "еда");
+  ASSERT_EQ(kept["zebra"], "зебра");
+  test_dict.Merge(glossary);
+  ASSERT_EQ(test_dict.GetSize(), 10);
+  ASSERT_EQ(test_dict["food"], "пища");
+  ASSERT_EQ(test_dict.Rank("bread"), 2);
+  ASSERT_EQ(glossary.GetSize(), 3);
+}
+TEST_F(DictionaryFixture, DiffAppliedMakesDictionariesEqual) {
+  Dictionary updated;
+  updated += "zebra:зебра";
+  updated += "food:пища";
+  updated += "apple:яблоко";
+  updated += "mine:шахта";
+  size_t added = 0, removed = 0, changed = 0;
+  Dictionary patched = test_dict;
+  test_dict.Diff(
+      updated,
+      [&](const Dictionary::String &word,
+          const Dictionary::String &translation) {
+        patched += std::make_pair(word, translation);
+        ++added;
+      },
+      [&](const Dictionary::String &word, const Dictionary::String &) {
+        patched -= word;
+        ++removed;
+      },
+      [&](const Dictionary::String &word, const Dictionary::String &,
+          const Dictionary::String &translation) {
+        patched += std::make_pair(word, translation);
+        ++changed;
+      });
+  ASSERT_EQ(added, 1);
+  ASSERT_EQ(removed, 5);
+  ASSERT_EQ(changed, 2);
+  ASSERT_TRUE(patched == updated);
+}
+TEST_F(DictionaryFixture, StatsDescribeTreeShape) {
+  TreeStatistics statistics = test_dict.Stats();
+  ASSERT_EQ(statistics.size, 8);
+  ASSERT_EQ(statistics.max_depth, statistics.depth_histogram.size());
+  ASSERT_LE(statistics.max_depth, 4);
+  ASSERT_EQ(statistics.depth_histogram.front(), 1);
+  size_t nodes = 0;
+  for (size_t count : statistics.depth_histogram) {
+    nodes += count;
+  }
+  ASSERT_EQ(nodes, 8);
+  ASSERT_GT(statistics.node_size, 2 * sizeof(std::string));
+  ASSERT_EQ(statistics.node_bytes, 8 * statistics.node_size);
+  ASSERT_EQ(Dictionary().Stats().max_depth, 0);
+}
+TEST_F(DictionaryFixture, LivesInMonotonicBuffer) {
+  std::vector<std::byte> buffer(1 << 16);
+  std::pmr::monotonic_buffer_resource arena(
+      buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  Dictionary glossary(&arena);
+  ASSERT_EQ(glossary.GetMemoryResource(), &arena);
+  glossary += "internationalization:интернационализация";
+  glossary += std::make_pair(std::string("hello"), std::string("здравствуйте"));
+  for (const auto &word_pair : test_dict) {
+    glossary += word_pair;
+  }
+  glossary["programmer"] = "разработчик";
+  ASSERT_EQ(glossary.GetSize(), 10);
+  ASSERT_EQ(glossary["internationalization"], "интернационализация");
+  ASSERT_EQ(glossary["programmer"], "разработчик");
+  ASSERT_EQ(glossary.Find("apple")->get_allocator().resource(), &arena);
+  Dictionary copy = glossary;
+  ASSERT_EQ(copy.GetMemoryResource(), &arena);
+  test_dict = glossary;
+  ASSERT_TRUE(test_dict == glossary);
+  ASSERT_EQ(test_dict.GetMemoryResource(), std::pmr::get_default_resource());
+}
+TEST(DictionaryNonFixture, MutableSubscriptLooksUpByView) {
+  Dictionary dict;
+  // Views reach the mutable overload, no std::string key is built
+  static_assert(std::is_same_v<decltype(dict[std::string_view()]),
+                               Dictionary::String &>);
+  CountingResource resource;
+  Dictionary counted(&resource);
+  counted += "internationalization:интернационализация";
+  std::string_view text = "internationalization and localization";
+  for (bool hash_index : {false, true}) {
+    counted.SetHashIndex(hash_index);
+    size_t allocations = resource.GetAllocations();
+    ASSERT_EQ(counted[text.substr(0, 20)], "интернационализация");
+    ASSERT_EQ(counted["internationalization"], "интернационализация");
+    ASSERT_EQ(resource.GetAllocations(), allocations);
+  }
+  size_t allocations = resource.GetAllocations();
+  counted["localization"] = "локализация";
+  ASSERT_GT(resource.GetAllocations(), allocations);
+}
+TEST_F(DictionaryFixture, HashIndexFollowsModifications) {
+  ASSERT_FALSE(test_dict.HasHashIndex());
+  Dictionary reference = test_dict;
+  test_dict.SetHashIndex(true);
+  ASSERT_TRUE(test_dict.HasHashIndex());
+  ASSERT_EQ(test_dict["apple"], "яблоко");
+  test_dict += "apple:яблоня";
+  test_dict += "world:мир";
+  test_dict -= "food";
+  test_dict["cat"] = "кот";
+  ASSERT_EQ(std::as_const(test_dict)["cat"], "кот");
+  reference += "apple:яблоня";
+  reference += "world:мир";
+  reference -= "food";
+  reference["cat"] = "кот";
+  ASSERT_TRUE(test_dict == reference);
+  ASSERT_EQ(test_dict["apple"], "яблоня");
+  ASSERT_EQ(*test_dict.Find("world"), "мир");
+  ASSERT_EQ(test_dict.Find("food"), nullptr);
+  ASSERT_FALSE(test_dict.Contains("food"));
+  ASSERT_THROW(test_dict -= "food", std::out_of_range);
+
+  Dictionary glossary;
+  glossary += "apple:яблочко";
+  glossary += "dog:собака";
+  test_dict.Merge(glossary, Dictionary::MergePolicy::kKeepExisting);
+  test_dict.Merge(glossary);
+  reference.Merge(glossary);
+  ASSERT_TRUE(test_dict == reference);
+  ASSERT_EQ(test_dict["apple"], "яблочко");
+  ASSERT_EQ(test_dict["dog"], "собака");
+
+  Dictionary copy = test_dict;
+  ASSERT_TRUE(copy.HasHashIndex());
+  test_dict.Clear();
+  ASSERT_FALSE(test_dict.Contains("dog"));
+  ASSERT_TRUE(copy.Contains("dog"));
+  reference = copy;
+  ASSERT_FALSE(reference.HasHashIndex());
+  test_dict = std::move(copy);
+  ASSERT_EQ(test_dict["cat"], "кот");
+  ASSERT_TRUE(test_dict.LoadFromFile(DICTIONARY_INPUT_FILE_PATH));
+  for (const auto &word_pair : test_dict) {
+    ASSERT_EQ(test_dict.Find(word_pair.first), &word_pair.second);
+  }
+  test_dict.SetHashIndex(false);
+  ASSERT_FALSE(test_dict.HasHashIndex());
+  ASSERT_EQ(test_dict.GetSize(), test_dict.Stats().size);
+}
+TEST_F(DictionaryFixture, LookupBatchMatchesFind) {
+  std::vector<std::string_view> words = {"apple", "mushroom", "cat", "test",
+                                         "", "Apple", "apple"};
+  for (bool hash_index : {false, true}) {
+    test_dict.SetHashIndex(hash_index);
+    std::vector<const Dictionary::String *> translations =
+        test_dict.LookupBatch(words);
+    ASSERT_EQ(translations.size(), words.size());
+    for (size_t index = 0; index < words.size(); ++index) {
+      ASSERT_EQ(translations[index], test_dict.Find(words[index]));
+    }
+    ASSERT_EQ(*translations[1], "гриб");
+    ASSERT_EQ(translations[2], nullptr);
+    ASSERT_TRUE(test_dict.LookupBatch(words.data(), 0).empty());
+  }
+  ASSERT_EQ(Dictionary().LookupBatch(words),
+            std::vector<const Dictionary::String *>(words.size()));
+}
+TEST_F(DictionaryFixture, CompleteWithoutWeightsIsAlphabetical) {
+  test_dict += "mild:мягкий";
+  test_dict += "milk:молоко";
+  auto words = [](const std::vector<const Dictionary::WordPair *> &pairs) {
+    std::vector<std::string_view> result;
+    for (const Dictionary::WordPair *word_pair : pairs)
+      result.push_back(word_pair->first);
+    return result;
+  };
+  ASSERT_EQ(words(test_dict.Complete("mi", 2)),
+            (std::vector<std::string_view>{"mild", "milk"}));
+  ASSERT_EQ(words(test_dict.Complete("mi", 10)),
+            (std::vector<std::string_view>{"mild", "milk", "mine"}));
+  ASSERT_EQ(test_dict.Complete("milk", 5).front()->second, "молоко");
+  ASSERT_TRUE(test_dict.Complete("zebra", 5).empty());
+  ASSERT_TRUE(test_dict.Complete("mi", 0).empty());
+  ASSERT_EQ(test_dict.Complete("", 100).size(), test_dict.GetSize());
+  ASSERT_THROW(test_dict.Complete("ми", 1), std::invalid_argument);
+}
+TEST_F(DictionaryFixture, CompleteReturnsHeaviestWords) {
+  test_dict += "mild:мягкий";
+  test_dict += "milk:молоко";
+  auto words = [](const std::vector<const Dictionary::WordPair *> &pairs) {
+    std::vector<std::string_view> result;
+    for (const Dictionary::WordPair *word_pair : pairs)
+      result.push_back(word_pair->first);
+    return result;
+  };
+  test_dict.SetWeight("mine", 5);
+  test_dict.SetWeight("milk", 9);
+  ASSERT_EQ(test_dict.GetWeight("milk"), 9);
+  ASSERT_EQ(test_dict.GetWeight("mild"), 0);
+  ASSERT_EQ(words(test_dict.Complete("mi", 3)),
+            (std::vector<std::string_view>{"milk", "mine", "mild"}));
+  ASSERT_EQ(words(test_dict.Complete("", 2)),
+            (std::vector<std::string_view>{"milk", "mine"}));
+  // Changing a weight updates the built index
+  test_dict.SetWeight("mild", 20);
+  test_dict.SetWeight("milk", 0);
+  ASSERT_EQ(words(test_dict.Complete("mi", 3)),
+            (std::vector<std::string_view>{"mild", "mine", "milk"}));
+  // Added and removed words shift positions of the others
+  test_dict += "mint:мята";
+  test_dict.SetWeight("mint", 7);
+  test_dict -= "mild";
+  ASSERT_EQ(test_dict.GetWeight("mild"), 0);
+  ASSERT_EQ(words(test_dict.Complete("mi", 2)),
+            (std::vector<std::string_view>{"mint", "mine"}));
+  Dictionary copy(test_dict);
+  ASSERT_EQ(words(copy.Complete("mi", 1)),
+            std::vector<std::string_view>{"mint"});
+  ASSERT_THROW(test_dict.SetWeight("zebra", 1), std::out_of_range);
+  ASSERT_THROW(test_dict.SetWeight("зебра", 1), std::invalid_argument);
+  test_dict.Clear();
+  test_dict += "mine:шахта";
+  ASSERT_EQ(test_dict.GetWeight("mine"), 0);
+}
+TEST(DictionaryNonFixture, MoveAssignmentTakesCompletionIndex) {
+  static_assert(std::is_nothrow_move_assignable_v<Dictionary>);
+  std::pmr::monotonic_buffer_resource arena;
+  Dictionary source(&arena);
+  source += "mild:мягкий";
+  source += "milk:молоко";
+  source.SetWeight("milk", 9);
+  ASSERT_EQ(source.Complete("mi", 1).front()->first, "milk");
+  // Anything allocated by target's own resource throws std::bad_alloc
+  Dictionary target(std::pmr::null_memory_resource());
+  target = std::move(source);
+  ASSERT_EQ(target.GetMemoryResource(), &arena);
+  target += "mint:мята";
+  target.SetWeight("mint", 10);
+  ASSERT_EQ(target.Complete("mi", 1).front()->first, "mint");
+}
+TEST(DictionaryNonFixture, LoadFromFileKeepsWeightsOfPresentWords) {
+  Dictionary dict;
+  dict += "craft:ремесло";
+  dict += "cat:кот";
+  dict += "zebra:зебра";
+  dict.SetWeight("craft", 3);
+  dict.SetWeight("zebra", 4);
+  ASSERT_TRUE(dict.LoadFromFile(DICTIONARY_INPUT_FILE_PATH));
+  ASSERT_EQ(dict.GetWeight("craft"), 3);
+  ASSERT_EQ(dict.GetWeight("zebra"), 0);
+  ASSERT_EQ(dict.Complete("", 1).front()->first, "craft");
+}
+TEST(DictionaryNonFixture, CompleteMatchesScanOfPrefix) {
+  Dictionary dict;
+  std::mt19937 generator(3);
+  for (size_t index = 0; index < 3000; ++index) {
+    std::string word(1 + generator() % 4, 'a');
+    for (char &letter : word)
+      letter = static_cast<char>('a' + generator() % 6);
+    dict += word + ":слово";
+  }
+  for (const Dictionary::WordPair &word_pair : dict)
+    dict.SetWeight(word_pair.first, generator() % 50);
+  for (std::string prefix : {"", "a", "fe", "cab", "dddd", "zz"}) {
+    auto range = dict.FindPrefix(prefix);
+    std::vector<const Dictionary::WordPair *> expected;
+    for (auto it = range.first; it != range.second; ++it)
+      expected.push_back(&*it);
+    std::stable_sort(expected.begin(), expected.end(),
+                     [&dict](const Dictionary::WordPair *word_pair,
+                             const Dictionary::WordPair *other) {
+                       return dict.GetWeight(word_pair->first) >
+                              dict.GetWeight(other->first);
+                     });
+    expected.resize(std::min<size_t>(expected.size(), 10));
+    ASSERT_EQ(dict.Complete(prefix, 10), expected) << prefix;
+  }
+}
+TEST(DictionaryNonFixture, LongPrefixesBoundTheirWords) {
+  Dictionary dict;
+  std::string stem(100, 'k');
+  for (std::string word : {stem, stem + "a", stem + "ab", stem + "b"})
+    dict += word + ":слово";
+  dict += stem.substr(1) + "l:слово";
+  dict += "a:слово";
+  auto range = dict.FindPrefix(stem + "a");
+  ASSERT_EQ(std::distance(range.first, range.second), 2);
+  ASSERT_EQ(dict.Complete(stem, 10).size(), 4);
+  ASSERT_EQ(std::string_view(dict.Complete(stem + "b", 10).front()->first),
+            stem + "b");
+}
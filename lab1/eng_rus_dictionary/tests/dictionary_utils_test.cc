@@ -47,3 +47,36 @@ TEST(UtilsTest, ParseWordPairOnlyDelimeter) {
   std::string eng, rus;
   EXPECT_THROW(utils::ParseWordPair(eng, rus, ":"), std::invalid_argument);
 }
+TEST(UtilsTest, NextPrefixIncrementsLastCharacter) {
+  char buffer[3];
+  EXPECT_EQ("apq", utils::NextPrefix("app", buffer));
+  EXPECT_EQ("b", utils::NextPrefix("a\xff", buffer));
+  EXPECT_EQ("", utils::NextPrefix("\xff\xff", buffer));
+  EXPECT_EQ("", utils::NextPrefix("", buffer));
+}
+TEST(UtilsTest, SplitWordPairMatchesParseWordPair) {
+  std::string_view eng, rus;
+  EXPECT_TRUE(utils::SplitWordPair("test:слово:лишнее", eng, rus));
+  EXPECT_EQ("test", eng);
+  EXPECT_EQ("слово", rus);
+  EXPECT_FALSE(utils::SplitWordPair("", eng, rus));
+  EXPECT_FALSE(utils::SplitWordPair(":", eng, rus));
+  EXPECT_FALSE(utils::SplitWordPair("test", eng, rus));
+  EXPECT_FALSE(utils::SplitWordPair("test:", eng, rus));
+  EXPECT_FALSE(utils::SplitWordPair("слово:test", eng, rus));
+}
+TEST(UtilsTest, SplitWordPairsSkipsInvalidLines) {
+  auto word_pairs =
+      utils::SplitWordPairs("word:слово\n\nbad line\n123:число\nlast:конец");
+  ASSERT_EQ(word_pairs.size(), 2);
+  EXPECT_EQ("word", word_pairs[0].first);
+  EXPECT_EQ("слово", word_pairs[0].second);
+  EXPECT_EQ("last", word_pairs[1].first);
+  EXPECT_EQ("конец", word_pairs[1].second);
+  EXPECT_TRUE(utils::SplitWordPairs("").empty());
+}
+TEST(UtilsTest, PackPrefixKeepsOrder) {
+  EXPECT_LT(utils::PackPrefix("app"), utils::PackPrefix("apple"));
+  EXPECT_LT(utils::PackPrefix("apple"), utils::PackPrefix("apq"));
+  EXPECT_EQ(utils::PackPrefix("abcdefghX"), utils::PackPrefix("abcdefghY"));
+}
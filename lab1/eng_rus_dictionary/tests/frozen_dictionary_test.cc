@@ -0,0 +1,91 @@
+//
+//  frozen_dictionary_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 10/11/2025.
+//
+
+#include "../src/frozen_dictionary/frozen_dictionary.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+class FrozenDictionaryFixture : public ::testing::Test {
+protected:
+  void SetUp() override {
+    source_dict += "test:тест";
+    source_dict += "food:еда";
+    source_dict += "apple:яблоко";
+    source_dict += "mushroom:гриб";
+    source_dict += "programmer:программист";
+    source_dict += "Object-Oriented-Programming:"
+                   "Объектно-Ориентированное-Программирование";
+    source_dict += "mine:добывать";
+    source_dict += "craft:ремесло";
+    source_dict += "programmers:программисты";
+    source_dict += "programme:программа";
+    frozen_dict = FrozenDictionary(source_dict);
+  }
+
+  Dictionary source_dict;
+  FrozenDictionary frozen_dict;
+};
+
+TEST(FrozenDictionaryNonFixture, EmptyDictionary) {
+  FrozenDictionary frozen;
+  ASSERT_TRUE(frozen.IsEmpty());
+  ASSERT_EQ(frozen.Find("word"), nullptr);
+  FrozenDictionary frozen_empty{Dictionary()};
+  ASSERT_EQ(frozen_empty.GetSize(), 0);
+  ASSERT_EQ(frozen_empty.Find("word"), nullptr);
+}
+TEST_F(FrozenDictionaryFixture, FindsEveryWord) {
+  ASSERT_EQ(frozen_dict.GetSize(), source_dict.GetSize());
+  for (const auto &word_pair : source_dict) {
+    const std::string *translation = frozen_dict.Find(word_pair.first);
+    ASSERT_NE(translation, nullptr) << word_pair.first;
+    ASSERT_EQ(*translation, std::string_view(word_pair.second));
+  }
+}
+TEST_F(FrozenDictionaryFixture, SharedPrefixWords) {
+  ASSERT_EQ(frozen_dict["programme"], "программа");
+  ASSERT_EQ(frozen_dict["programmer"], "программист");
+  ASSERT_EQ(frozen_dict["programmers"], "программисты");
+  ASSERT_EQ(frozen_dict.Find("programm"), nullptr);
+  ASSERT_EQ(frozen_dict.Find("programmerss"), nullptr);
+}
+TEST_F(FrozenDictionaryFixture, MissingWords) {
+  ASSERT_EQ(frozen_dict.Find("a"), nullptr);
+  ASSERT_EQ(frozen_dict.Find("zzz"), nullptr);
+  ASSERT_EQ(frozen_dict.Find("grape"), nullptr);
+  ASSERT_FALSE(frozen_dict.Contains("apples"));
+  ASSERT_THROW(frozen_dict["grape"], std::out_of_range);
+  ASSERT_THROW(frozen_dict["яблоко"], std::invalid_argument);
+}
+TEST_F(FrozenDictionaryFixture, IndependentFromSource) {
+  source_dict["apple"] = "изменено";
+  source_dict -= "food";
+  ASSERT_EQ(frozen_dict["apple"], "яблоко");
+  ASSERT_TRUE(frozen_dict.Contains("food"));
+}
+TEST_F(FrozenDictionaryFixture, OutputMatchesDictionary) {
+  std::ostringstream frozen_output, source_output;
+  frozen_output << frozen_dict;
+  source_output << source_dict;
+  ASSERT_EQ(frozen_output.str(), source_output.str());
+}
+TEST(FrozenDictionaryNonFixture, ManyWords) {
+  Dictionary dict;
+  for (char first = 'a'; first <= 'z'; ++first) {
+    for (char second = 'a'; second <= 'z'; ++second) {
+      dict += std::string{first, second, 'x'} + ":слово";
+    }
+  }
+  FrozenDictionary frozen(dict);
+  ASSERT_EQ(frozen.GetSize(), 26 * 26);
+  ASSERT_TRUE(frozen.Contains("aax"));
+  ASSERT_TRUE(frozen.Contains("zzx"));
+  ASSERT_TRUE(frozen.Contains("mqx"));
+  ASSERT_FALSE(frozen.Contains("mq"));
+  ASSERT_FALSE(frozen.Contains("mqxa"));
+}
@@ -0,0 +1,106 @@
+//
+//  hash_index_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 19/11/2025.
+//
+
+#include "../src/hash_index/hash_index.hpp"
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Element = std::pair<const std::string, int>;
+
+/**
+ * @brief Hash sending every key to the same few slots, so that erasing
+ * has to shift long probe sequences across the end of the table.
+ */
+struct CollidingHash {
+  size_t operator()(std::string_view key) const { return 13 + key.size() % 3; }
+};
+
+} // namespace
+
+TEST(HashIndexTest, FindsInsertedElements) {
+  std::list<Element> elements{{"hello", 1}, {"world", 2}};
+  HashIndex<Element> index;
+  ASSERT_EQ(nullptr, index.Find("hello"));
+  ASSERT_FALSE(index.Erase("hello"));
+  for (Element &element : elements) {
+    index.Insert(&element);
+  }
+  ASSERT_EQ(2, index.GetSize());
+  ASSERT_EQ(&elements.front(), index.Find("hello"));
+  ASSERT_EQ(2, index.Find(std::string("world"))->second);
+  ASSERT_EQ(nullptr, index.Find("hell"));
+  ASSERT_TRUE(index.Erase("hello"));
+  ASSERT_FALSE(index.Erase("hello"));
+  ASSERT_EQ(nullptr, index.Find("hello"));
+  ASSERT_EQ(&elements.back(), index.Find("world"));
+  index.Clear();
+  ASSERT_EQ(0, index.GetSize());
+  ASSERT_EQ(nullptr, index.Find("world"));
+}
+TEST(HashIndexTest, RandomInsertEraseMatchesUnorderedMap) {
+  std::list<Element> elements;
+  std::unordered_map<std::string, Element *> expected;
+  HashIndex<Element, std::string_view, CollidingHash> colliding;
+  HashIndex<Element> index;
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> key_distribution(0, 500);
+  for (int i = 0; i < 20000; ++i) {
+    std::string key = std::to_string(key_distribution(generator));
+    auto found = expected.find(key);
+    if (found != expected.end() && generator() % 2 == 0) {
+      ASSERT_TRUE(index.Erase(key));
+      ASSERT_TRUE(colliding.Erase(key));
+      expected.erase(found);
+    } else if (found == expected.end()) {
+      Element *element = &elements.emplace_back(key, i);
+      index.Insert(element);
+      colliding.Insert(element);
+      expected.emplace(key, element);
+    }
+    ASSERT_EQ(expected.size(), index.GetSize());
+  }
+  for (int key = 0; key <= 500; ++key) {
+    auto found = expected.find(std::to_string(key));
+    Element *element = found == expected.end() ? nullptr : found->second;
+    ASSERT_EQ(element, index.Find(std::to_string(key)));
+    ASSERT_EQ(element, colliding.Find(std::to_string(key)));
+  }
+}
+TEST(HashIndexTest, TableComesFromMemoryResource) {
+  std::vector<std::byte> buffer(1 << 12);
+  std::pmr::monotonic_buffer_resource arena(
+      buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  std::vector<Element> elements;
+  elements.reserve(12);
+  for (int i = 0; i < 12; ++i) {
+    elements.emplace_back(std::to_string(i), i);
+  }
+  HashIndex<Element> index(&arena);
+  ASSERT_EQ(0, index.GetMemoryUsage());
+  index.Reserve(elements.size());
+  ASSERT_EQ(16 * 2 * sizeof(void *), index.GetMemoryUsage());
+  for (Element &element : elements) {
+    index.Insert(&element);
+  }
+  // 12 elements fill 3/4 of 16 slots, the next one doubles the table
+  ASSERT_EQ(16 * 2 * sizeof(void *), index.GetMemoryUsage());
+  HashIndex<Element> moved(std::move(index));
+  ASSERT_EQ(0, index.GetSize());
+  ASSERT_EQ(&elements[7], moved.Find("7"));
+  index = std::move(moved);
+  ASSERT_EQ(&elements[11], index.Find("11"));
+}
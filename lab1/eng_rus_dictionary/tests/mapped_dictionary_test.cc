@@ -0,0 +1,66 @@
+//
+//  mapped_dictionary_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 20/11/2025.
+//
+
+#include "../src/mapped_dictionary/mapped_dictionary.h"
+#include "temp_path.h"
+#include <gtest/gtest.h>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+class MappedDictionaryFixture : public ::testing::Test {
+protected:
+  void SetUp() override {
+    dict.emplace(path);
+    *dict += "test:тест";
+    *dict += "food:еда";
+    *dict += std::make_pair(std::string("apple"), std::string("яблоко"));
+  }
+  void TearDown() override { dict.reset(); }
+
+  TempPath temp{"mapped_dictionary.tree"};
+  const std::string &path = temp.Get();
+  std::optional<MappedDictionary> dict;
+};
+
+TEST_F(MappedDictionaryFixture, AddRemoveAndLookup) {
+  ASSERT_EQ(dict->GetSize(), 3);
+  ASSERT_EQ((*dict)["food"], "еда");
+  *dict += "food:пища";
+  ASSERT_EQ((*dict)["food"], "пища");
+  *dict -= "food";
+  ASSERT_FALSE(dict->Contains("food"));
+  ASSERT_FALSE(dict->Find("food").has_value());
+  ASSERT_THROW(*dict -= "food", std::out_of_range);
+  ASSERT_THROW((*dict)["food"], std::out_of_range);
+  ASSERT_THROW((*dict)["еда"], std::invalid_argument);
+  ASSERT_THROW(*dict += "food:food", std::invalid_argument);
+  ASSERT_EQ(dict->GetSize(), 2);
+}
+TEST_F(MappedDictionaryFixture, ReopensWithoutLoading) {
+  *dict += "mushroom:гриб";
+  dict->Sync();
+  dict.emplace(path);
+  ASSERT_EQ(dict->GetSize(), 4);
+  ASSERT_EQ((*dict)["mushroom"], "гриб");
+  std::ostringstream out;
+  out << *dict;
+  ASSERT_EQ(out.str(), "apple:яблоко\nfood:еда\nmushroom:гриб\ntest:тест\n");
+}
+TEST_F(MappedDictionaryFixture, AssignCopiesDictionary) {
+  Dictionary source;
+  source += "hello:привет";
+  source += "world:мир";
+  dict->Assign(source);
+  ASSERT_EQ(dict->GetSize(), 2);
+  ASSERT_EQ((*dict)["world"], "мир");
+  ASSERT_FALSE(dict->Contains("apple"));
+  dict->Clear();
+  ASSERT_TRUE(dict->IsEmpty());
+}
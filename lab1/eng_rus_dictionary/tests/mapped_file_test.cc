@@ -0,0 +1,41 @@
+//
+//  mapped_file_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 22/11/2025.
+//
+
+#include "../src/mapped_file/mapped_file.h"
+#include "temp_path.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <system_error>
+#include <utility>
+
+TEST(MappedFileTest, ContentsMatchFile) {
+  TempPath temp("mapped_file_test.txt", "word:слово\nlast:конец");
+  MappedFile file(temp.Get());
+  ASSERT_EQ(file.GetContents(), "word:слово\nlast:конец");
+  ASSERT_EQ(file.GetSize(), file.GetContents().size());
+}
+
+TEST(MappedFileTest, EmptyFile) {
+  TempPath temp("mapped_file_test_empty.txt", "");
+  MappedFile file(temp.Get());
+  ASSERT_TRUE(file.GetContents().empty());
+}
+
+TEST(MappedFileTest, MissingFileThrows) {
+  ASSERT_THROW(MappedFile("no/such/file.txt"), std::system_error);
+}
+
+TEST(MappedFileTest, MoveTakesMapping) {
+  TempPath temp("mapped_file_test_move.txt", "word:слово");
+  MappedFile file(temp.Get());
+  MappedFile moved(std::move(file));
+  ASSERT_EQ(moved.GetContents(), "word:слово");
+  ASSERT_EQ(file.GetSize(), 0);
+  file = std::move(moved);
+  ASSERT_EQ(file.GetContents(), "word:слово");
+}
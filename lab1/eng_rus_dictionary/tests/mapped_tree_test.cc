@@ -0,0 +1,137 @@
+//
+//  mapped_tree_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 20/11/2025.
+//
+
+#include "../src/mapped_tree/mapped_tree.h"
+#include "temp_path.h"
+#include <cmath>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<std::pair<std::string, std::string>>
+Contents(const MappedTree &tree) {
+  std::vector<std::pair<std::string, std::string>> contents;
+  tree.InOrderTraversal([&](std::string_view key, std::string_view value) {
+    contents.emplace_back(key, value);
+  });
+  return contents;
+}
+
+} // namespace
+
+TEST(MappedTreeTest, NewFileIsEmpty) {
+  TempPath path("mapped_tree_empty.tree");
+  MappedTree tree(path.Get());
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_EQ(0, tree.GetHeight());
+  ASSERT_FALSE(tree.Find("hello").has_value());
+  ASSERT_FALSE(tree.Erase("hello"));
+  ASSERT_TRUE(Contents(tree).empty());
+}
+TEST(MappedTreeTest, RandomInsertEraseMatchesStdMap) {
+  TempPath path("mapped_tree_random.tree");
+  std::map<std::string, std::string> expected;
+  {
+    MappedTree tree(path.Get());
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> key_distribution(0, 3000);
+    for (int i = 0; i < 30000; ++i) {
+      std::string key = std::to_string(key_distribution(generator));
+      if (generator() % 3 == 0) {
+        ASSERT_EQ(expected.erase(key) == 1, tree.Erase(key));
+      } else {
+        // Values of different lengths move between size classes
+        std::string value(generator() % 40, 'a' + i % 26);
+        ASSERT_EQ(expected.insert_or_assign(key, value).second,
+                  tree.Insert(key, value));
+      }
+    }
+    ASSERT_EQ(expected.size(), tree.GetSize());
+    ASSERT_LE(tree.GetHeight(), 1.45 * std::log2(expected.size() + 2));
+    ASSERT_GT(tree.GetFileSize(), size_t{1} << 16);
+    tree.Sync();
+  }
+  MappedTree reopened(path.Get());
+  std::vector<std::pair<std::string, std::string>> expected_pairs(
+      expected.begin(), expected.end());
+  ASSERT_EQ(expected_pairs, Contents(reopened));
+  for (const auto &[key, value] : expected) {
+    ASSERT_EQ(value, reopened.Find(key));
+  }
+}
+TEST(MappedTreeTest, ErasedSpaceIsReused) {
+  TempPath path("mapped_tree_reuse.tree");
+  MappedTree tree(path.Get());
+  for (int i = 0; i < 1000; ++i) {
+    tree.Insert(std::to_string(i), "value");
+  }
+  size_t file_size = tree.GetFileSize();
+  for (int round = 0; round < 20; ++round) {
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_TRUE(tree.Erase(std::to_string(i)));
+    }
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_TRUE(tree.Insert(std::to_string(i), "value"));
+    }
+  }
+  ASSERT_EQ(file_size, tree.GetFileSize());
+  tree.Clear();
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_FALSE(tree.Contains("1"));
+}
+TEST(MappedTreeTest, InsertsViewsIntoTheTree) {
+  TempPath path("mapped_tree_views.tree");
+  MappedTree tree(path.Get());
+  // The same size class gets the block back, its first bytes hold the key
+  // and the start of the value
+  tree.Insert("a", "abcdefghijkl");
+  ASSERT_FALSE(tree.Insert("a", *tree.Find("a")));
+  ASSERT_EQ("abcdefghijkl", tree.Find("a"));
+  std::string_view key;
+  tree.InOrderTraversal(
+      [&key](std::string_view tree_key, std::string_view) { key = tree_key; });
+  ASSERT_FALSE(tree.Insert(key, "mnopqrstuvwx"));
+  ASSERT_EQ("mnopqrstuvwx", tree.Find("a"));
+  // Values copied from the tree make the file grow and remap
+  size_t file_size = tree.GetFileSize();
+  tree.Insert("big", std::string(file_size / 4, 'b'));
+  for (int i = 0; i < 8; ++i)
+    tree.Insert("copy" + std::to_string(i), *tree.Find("big"));
+  ASSERT_LT(file_size, tree.GetFileSize());
+  for (int i = 0; i < 8; ++i)
+    ASSERT_EQ(std::string(file_size / 4, 'b'),
+              tree.Find("copy" + std::to_string(i)));
+}
+TEST(MappedTreeTest, MoveKeepsMapping) {
+  TempPath path("mapped_tree_move.tree");
+  MappedTree tree(path.Get());
+  tree.Insert("hello", "привет");
+  MappedTree moved(std::move(tree));
+  ASSERT_EQ("привет", moved.Find("hello"));
+  TempPath other_path("mapped_tree_move_other.tree");
+  MappedTree other(other_path.Get());
+  other = std::move(moved);
+  ASSERT_EQ(1, other.GetSize());
+}
+TEST(MappedTreeTest, RejectsForeignFiles) {
+  TempPath path("mapped_tree_foreign.tree");
+  {
+    std::ofstream file(path.Get());
+    file << std::string(4096, 'x');
+  }
+  ASSERT_THROW(MappedTree tree(path.Get()), std::runtime_error);
+  ASSERT_THROW(MappedTree tree("/nonexistent/directory/words.tree"),
+               std::system_error);
+}
@@ -0,0 +1,155 @@
+//
+//  persistent_tree_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 14/11/2025.
+//
+
+#include "../src/persistent_tree/persistent_tree.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Value type counting how many times any instance was copied.
+ */
+struct CountedValue {
+  static inline int copies = 0;
+  int value = 0;
+
+  CountedValue(int v = 0) : value(v) {}
+  CountedValue(const CountedValue &other) : value(other.value) { ++copies; }
+  CountedValue(CountedValue &&other) noexcept = default;
+  CountedValue &operator=(const CountedValue &other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  CountedValue &operator=(CountedValue &&other) noexcept = default;
+  bool operator==(const CountedValue &other) const {
+    return value == other.value;
+  }
+};
+
+template <typename Tree>
+std::map<int, int> ToMap(const Tree &tree) {
+  std::map<int, int> result;
+  tree.InOrderTraversal(
+      [&result](const int &key, const int &value) { result[key] = value; });
+  return result;
+}
+
+} // namespace
+
+TEST(PersistentTreeTest, InsertFindErase) {
+  PersistentTree<std::string, std::string> tree;
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_TRUE(tree.Insert("hello", "привет"));
+  ASSERT_TRUE(tree.Insert("world", "мир"));
+  ASSERT_FALSE(tree.Insert("hello", "здравствуй"));
+  ASSERT_EQ(tree.GetSize(), 2);
+  ASSERT_EQ(tree["hello"], "здравствуй");
+  ASSERT_TRUE(tree.Contains(std::string_view("world")));
+  ASSERT_EQ(tree.Find("apple"), nullptr);
+  ASSERT_THROW(tree["apple"], std::out_of_range);
+  ASSERT_FALSE(tree.Erase("apple"));
+  ASSERT_TRUE(tree.Erase("hello"));
+  ASSERT_EQ(tree.GetSize(), 1);
+  ASSERT_FALSE(tree.Contains("hello"));
+  tree.Clear();
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_EQ(tree.begin(), tree.end());
+}
+
+TEST(PersistentTreeTest, SnapshotIsNotAffectedByMutations) {
+  PersistentTree<int, int> tree;
+  for (int i = 0; i < 100; ++i)
+    tree.Insert(i, i);
+  PersistentTree<int, int> snapshot = tree.Snapshot();
+  ASSERT_EQ(snapshot, tree);
+  tree.Insert(1000, 1000);
+  tree.Insert(5, -5);
+  tree.Erase(50);
+  ASSERT_EQ(snapshot.GetSize(), 100);
+  ASSERT_EQ(snapshot[5], 5);
+  ASSERT_TRUE(snapshot.Contains(50));
+  ASSERT_FALSE(snapshot.Contains(1000));
+  ASSERT_EQ(tree[5], -5);
+  ASSERT_FALSE(tree.Contains(50));
+  ASSERT_NE(snapshot, tree);
+  snapshot.Erase(0);
+  ASSERT_TRUE(tree.Contains(0));
+}
+
+TEST(PersistentTreeTest, RandomOperationsMatchMapSnapshots) {
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<int> key_distribution(0, 499);
+  PersistentTree<int, int> tree;
+  std::map<int, int> reference;
+  std::vector<PersistentTree<int, int>> snapshots;
+  std::vector<std::map<int, int>> expected;
+  for (int step = 0; step < 5000; ++step) {
+    int key = key_distribution(generator);
+    if (generator() % 3 == 0) {
+      ASSERT_EQ(tree.Erase(key), reference.erase(key) == 1);
+    } else {
+      ASSERT_EQ(tree.Insert(key, step), reference.count(key) == 0);
+      reference[key] = step;
+    }
+    if (step % 500 == 0) {
+      snapshots.push_back(tree);
+      expected.push_back(reference);
+    }
+  }
+  ASSERT_EQ(ToMap(tree), reference);
+  ASSERT_EQ(tree.GetSize(), reference.size());
+  ASSERT_LE(tree.GetHeight(), 1.45 * std::log2(tree.GetSize() + 2));
+  for (size_t i = 0; i < snapshots.size(); ++i) {
+    ASSERT_EQ(ToMap(snapshots[i]), expected[i]);
+    ASSERT_EQ(snapshots[i].GetSize(), expected[i].size());
+  }
+}
+
+TEST(PersistentTreeTest, MutationAfterSnapshotCopiesLogarithmicNodes) {
+  const int size = 1 << 12;
+  PersistentTree<int, CountedValue> tree;
+  for (int i = 0; i < size; ++i)
+    tree.Insert(i, CountedValue(i));
+  PersistentTree<int, CountedValue> snapshot = tree;
+  // Every node on the path is copied once, rotations copy a few more
+  int limit = 3 * static_cast<int>(tree.GetHeight()) + 4;
+  CountedValue::copies = 0;
+  tree.Insert(size, CountedValue(size));
+  ASSERT_LE(CountedValue::copies, limit);
+  CountedValue::copies = 0;
+  tree.Erase(size / 2);
+  ASSERT_LE(CountedValue::copies, limit);
+  CountedValue::copies = 0;
+  PersistentTree<int, CountedValue> copy = tree;
+  ASSERT_EQ(CountedValue::copies, 0);
+  ASSERT_EQ(snapshot.GetSize(), size);
+  ASSERT_EQ(tree.GetSize(), size);
+  ASSERT_EQ(snapshot[size / 2].value, size / 2);
+}
+
+TEST(PersistentTreeTest, IteratorsAndMove) {
+  PersistentTree<int, int> tree;
+  for (int key : {5, 3, 8, 1, 4, 7, 9})
+    tree.Insert(key, key * 10);
+  std::vector<int> keys;
+  for (const auto &pair : tree)
+    keys.push_back(pair.first);
+  std::vector<int> expected_keys = {1, 3, 4, 5, 7, 8, 9};
+  ASSERT_EQ(keys, expected_keys);
+  PersistentTree<int, int> moved(std::move(tree));
+  ASSERT_EQ(moved.GetSize(), 7);
+  ASSERT_TRUE(tree.IsEmpty());
+  tree = std::move(moved);
+  ASSERT_EQ(tree.GetSize(), 7);
+  ASSERT_EQ(tree.begin()->second, 10);
+}
@@ -0,0 +1,103 @@
+//
+//  static_dictionary_test.cc
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 21/11/2025.
+//
+
+#include "../src/dictionary/dictionary.h"
+#include "../src/static_dictionary/static_dictionary.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view kVocabulary = R"(test:тест
+food:еда
+apple:яблоко
+mushroom:гриб
+
+programmer:программист
+Object-Oriented-Programming:Объектно-Ориентированное-Программирование
+mine:добывать
+craft:ремесло
+programmers:программисты
+programme:программа
+)";
+
+constexpr StaticDictionary<CountWordPairs(kVocabulary)> kDict(kVocabulary);
+
+// Everything below is checked by the compiler
+static_assert(CountWordPairs(kVocabulary) == 10);
+static_assert(kDict.GetSize() == 10);
+static_assert(kDict.Contains("apple"));
+static_assert(!kDict.Contains("banana"));
+static_assert(*kDict.Find("mine") == "добывать");
+static_assert(kDict["food"] == "еда");
+static_assert(kDict.begin()->first == "Object-Oriented-Programming");
+static_assert(kDict.Rank("b") == 2);
+static_assert(kDict.CountRange("p", "q") == 3);
+static_assert(kDict.Select(10) == kDict.end());
+
+} // namespace
+
+TEST(StaticDictionaryTest, MatchesLoadedDictionary) {
+  Dictionary dict;
+  std::istringstream in_stream{std::string(kVocabulary)};
+  in_stream >> dict;
+  ASSERT_EQ(dict.GetSize(), kDict.GetSize());
+  auto it = dict.begin();
+  for (const auto &word_pair : kDict) {
+    ASSERT_EQ(std::string_view(it->first), word_pair.first);
+    ASSERT_EQ(std::string_view(it->second), word_pair.second);
+    ++it;
+  }
+  std::ostringstream expected, actual;
+  expected << dict;
+  actual << kDict;
+  ASSERT_EQ(actual.str(), expected.str());
+}
+
+TEST(StaticDictionaryTest, Lookups) {
+  ASSERT_EQ(kDict["programmer"], "программист");
+  ASSERT_EQ(kDict.Find("program"), nullptr);
+  ASSERT_THROW(kDict["banana"], std::out_of_range);
+  ASSERT_THROW(kDict["яблоко"], std::invalid_argument);
+  ASSERT_THROW(kDict.Rank(""), std::invalid_argument);
+}
+
+TEST(StaticDictionaryTest, RangesAndPrefixes) {
+  auto range = kDict.FindPrefix("programme");
+  ASSERT_EQ(range.second - range.first, 3);
+  ASSERT_EQ(range.first->first, "programme");
+  ASSERT_EQ((range.second - 1)->first, "programmers");
+  range = kDict.FindPrefix("");
+  ASSERT_EQ(range.second - range.first, 10);
+  range = kDict.FindPrefix("z");
+  ASSERT_EQ(range.first, range.second);
+  range = kDict.FindRange("craft", "mine");
+  ASSERT_EQ(range.second - range.first, 3);
+  ASSERT_EQ(kDict.CountRange("z", "a"), 0);
+  ASSERT_THROW(kDict.FindPrefix("при"), std::invalid_argument);
+  ASSERT_EQ(kDict.Select(1)->first, "apple");
+}
+
+TEST(StaticDictionaryTest, EmptyDictionary) {
+  constexpr StaticDictionary<0> empty("\n\n");
+  static_assert(empty.IsEmpty());
+  ASSERT_EQ(empty.Find("word"), nullptr);
+  ASSERT_EQ(empty.begin(), empty.end());
+}
+
+TEST(StaticDictionaryTest, InvalidTextThrowsAtRunTime) {
+  // In a constexpr declaration each of these fails to compile
+  ASSERT_THROW(StaticDictionary<1>("apple"), std::invalid_argument);
+  ASSERT_THROW(StaticDictionary<1>("apple:apple"), std::invalid_argument);
+  ASSERT_THROW(StaticDictionary<1>("яблоко:apple"), std::invalid_argument);
+  ASSERT_THROW(StaticDictionary<2>("apple:яблоко"), std::invalid_argument);
+  ASSERT_THROW(StaticDictionary<1>("a:а\nb:б"), std::invalid_argument);
+  ASSERT_THROW(StaticDictionary<2>("a:а\na:б"), std::invalid_argument);
+}
@@ -0,0 +1,71 @@
+//
+//  temp_path.h
+//  eng_rus_dictionary
+//
+//  Created by Dmitry Burbas on 24/11/2025.
+//
+
+#ifndef TEMP_PATH_H
+#define TEMP_PATH_H
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+/**
+ * @brief Path of a file in the temporary directory, removed on
+ * construction and on destruction.
+ *
+ * The name gets a suffix unique to the test process, so that test
+ * binaries run in parallel don't share files, and a file left by a
+ * crashed run is removed before use.
+ */
+class TempPath {
+public:
+  /**
+   * @brief Makes a path for a file that doesn't exist yet.
+   * @param name File name, the suffix is inserted before its extension
+   */
+  explicit TempPath(const std::string &name)
+      : path_((std::filesystem::temp_directory_path() / UniqueName(name))
+                  .string()) {
+    std::remove(path_.c_str());
+  }
+
+  /**
+   * @brief Makes a path and writes a file with given contents to it.
+   * @param name File name, the suffix is inserted before its extension
+   * @param contents Bytes of the file
+   */
+  TempPath(const std::string &name, const std::string &contents)
+      : TempPath(name) {
+    std::ofstream(path_, std::ios::binary) << contents;
+  }
+
+  TempPath(const TempPath &) = delete;
+  TempPath &operator=(const TempPath &) = delete;
+
+  ~TempPath() { std::remove(path_.c_str()); }
+
+  const std::string &Get() const { return path_; }
+
+private:
+  std::string path_; ///< Path of the file
+
+  /**
+   * @brief Inserts the suffix of this process into a file name.
+   */
+  static std::string UniqueName(const std::string &name) {
+    static const std::string suffix = [] {
+      std::random_device device;
+      return "-" + std::to_string(device()) + std::to_string(device());
+    }();
+    std::filesystem::path file_name(name);
+    return file_name.stem().string() + suffix +
+           file_name.extension().string();
+  }
+};
+
+#endif // TEMP_PATH_H